@@ -0,0 +1,41 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef BATCH_DECODER_HH
+#define BATCH_DECODER_HH
+
+#include "thread_pool.hh"
+
+template <typename CODEC>
+class BatchDecoder
+{
+public:
+	typedef typename CODEC::value_type value_type;
+	static const int N = CODEC::N;
+	CODEC &codec;
+	ThreadPool &pool;
+	BatchDecoder(CODEC &codec, ThreadPool &pool) : codec(codec), pool(pool)
+	{
+	}
+	// block i starts at codes + (size_t)i * N, its erasures_counts[i] erasures at erasures + (size_t)i * stride
+	void decode(value_type *codes, int *results, int blocks, value_type *erasures = 0, int *erasures_counts = 0, int stride = 0)
+	{
+		pool.run(blocks, [=](int i) {
+			int count = erasures_counts ? erasures_counts[i] : 0;
+			results[i] = codec.decode(codes + (size_t)i * N, count ? erasures + (size_t)i * stride : 0, count);
+		});
+	}
+	// same as above with the same number of erasures for every block
+	void decode(value_type *codes, int *results, int blocks, value_type *erasures, int erasures_count, int stride)
+	{
+		pool.run(blocks, [=](int i) {
+			results[i] = codec.decode(codes + (size_t)i * N, erasures_count ? erasures + (size_t)i * stride : 0, erasures_count);
+		});
+	}
+};
+
+#endif
@@ -0,0 +1,199 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include "galois_field.hh"
+#include "reed_solomon.hh"
+#include "bose_chaudhuri_hocquenghem.hh"
+
+/*
+Each measurement runs one operation over a batch of blocks, once untimed to warm up and then for a number of repetitions.
+Reported are order statistics of the per block times over the repetitions and the throughput at the median.
+All inputs come from a fixed seed, so runs on different commits see the same data.
+Restoring the corrupted blocks happens before each timed run and is not part of the measurement.
+*/
+
+struct Measurement
+{
+	std::string code, operation;
+	int errors, blocks, length, failures;
+	std::vector<double> seconds;
+	double nanoseconds(int percent) const
+	{
+		return 1e9 * seconds[(seconds.size() - 1) * percent / 100] / blocks;
+	}
+	double blocks_per_second() const
+	{
+		return 1e9 / nanoseconds(50);
+	}
+	double symbols_per_second() const
+	{
+		return blocks_per_second() * length;
+	}
+};
+
+template <typename PREPARE, typename RUN>
+std::vector<double> repeat(int repetitions, PREPARE prepare, RUN run)
+{
+	prepare();
+	run();
+	std::vector<double> seconds(repetitions);
+	for (int r = 0; r < repetitions; ++r) {
+		prepare();
+		auto start = std::chrono::steady_clock::now();
+		run();
+		auto end = std::chrono::steady_clock::now();
+		seconds[r] = std::chrono::duration<double>(end - start).count();
+	}
+	std::sort(seconds.begin(), seconds.end());
+	return seconds;
+}
+
+template <typename CODEC>
+void benchmark(std::vector<Measurement> &measurements, std::string name, CODEC &codec, int K, int T, int symbol_max, int repetitions, unsigned seed)
+{
+	typedef typename CODEC::value_type TYPE;
+	const int N = CODEC::N;
+	// enough blocks per run to be well above the clock resolution, even for the smallest codes
+	const int blocks = std::max(4, 65536 / N);
+	std::default_random_engine generator(seed);
+	std::uniform_int_distribution<int> symbol(0, symbol_max), noise(1, symbol_max), position(0, N-1);
+	std::vector<TYPE> orig(blocks * N), code(blocks * N), corrupt(blocks * N);
+	std::vector<int> results(blocks), positions(T);
+	for (int b = 0; b < blocks; ++b) {
+		for (int i = 0; i < K; ++i)
+			orig[b*N+i] = symbol(generator);
+		codec.encode(&orig[b*N]);
+	}
+	{
+		Measurement m = { name, "encode", 0, blocks, N, 0, {} };
+		m.seconds = repeat(repetitions,
+			[&](){ std::copy(orig.begin(), orig.end(), code.begin()); },
+			[&](){ for (int b = 0; b < blocks; ++b) codec.encode(&code[b*N]); });
+		m.failures = 0;
+		for (int b = 0; b < blocks; ++b)
+			m.failures += !std::equal(orig.begin() + b*N, orig.begin() + (b+1)*N, code.begin() + b*N);
+		measurements.push_back(m);
+	}
+	std::vector<int> counts(1, 0);
+	for (int errors = std::max(1, T / 8); errors < T; errors += std::max(1, T / 8))
+		counts.push_back(errors);
+	counts.push_back(T);
+	for (int errors: counts) {
+		corrupt = orig;
+		for (int b = 0; b < blocks; ++b) {
+			for (int i = 0; i < errors; ++i) {
+				for (bool again = true; again;) {
+					positions[i] = position(generator);
+					again = false;
+					for (int j = 0; j < i; ++j)
+						again |= positions[j] == positions[i];
+				}
+				corrupt[b*N+positions[i]] ^= noise(generator);
+			}
+		}
+		Measurement m = { name, "decode", errors, blocks, N, 0, {} };
+		m.seconds = repeat(repetitions,
+			[&](){ std::copy(corrupt.begin(), corrupt.end(), code.begin()); },
+			[&](){ for (int b = 0; b < blocks; ++b) results[b] = codec.decode(&code[b*N]); });
+		m.failures = 0;
+		for (int b = 0; b < blocks; ++b)
+			m.failures += results[b] != errors || !std::equal(orig.begin() + b*N, orig.begin() + (b+1)*N, code.begin() + b*N);
+		measurements.push_back(m);
+	}
+}
+
+void print_csv(std::vector<Measurement> &measurements)
+{
+	std::cout << "code,operation,errors,blocks,length,repetitions,min_ns,p10_ns,median_ns,p90_ns,max_ns,blocks_per_second,symbols_per_second,failures" << std::endl;
+	std::cout << std::fixed << std::setprecision(1);
+	for (auto &m: measurements)
+		std::cout << "\"" << m.code << "\"," << m.operation << "," << m.errors << "," << m.blocks << "," << m.length << "," << m.seconds.size() << ","
+			<< m.nanoseconds(0) << "," << m.nanoseconds(10) << "," << m.nanoseconds(50) << "," << m.nanoseconds(90) << "," << m.nanoseconds(100) << ","
+			<< m.blocks_per_second() << "," << m.symbols_per_second() << "," << m.failures << std::endl;
+}
+
+void print_json(std::vector<Measurement> &measurements)
+{
+	std::cout << "[" << std::endl << std::fixed << std::setprecision(1);
+	for (size_t i = 0; i < measurements.size(); ++i) {
+		Measurement &m = measurements[i];
+		std::cout << "\t{ \"code\": \"" << m.code << "\", \"operation\": \"" << m.operation << "\", \"errors\": " << m.errors
+			<< ", \"blocks\": " << m.blocks << ", \"length\": " << m.length << ", \"repetitions\": " << m.seconds.size()
+			<< ", \"min_ns\": " << m.nanoseconds(0) << ", \"p10_ns\": " << m.nanoseconds(10) << ", \"median_ns\": " << m.nanoseconds(50)
+			<< ", \"p90_ns\": " << m.nanoseconds(90) << ", \"max_ns\": " << m.nanoseconds(100)
+			<< ", \"blocks_per_second\": " << m.blocks_per_second() << ", \"symbols_per_second\": " << m.symbols_per_second()
+			<< ", \"failures\": " << m.failures << " }" << (i + 1 < measurements.size() ? "," : "") << std::endl;
+	}
+	std::cout << "]" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	// usage: bench [csv|json] [repetitions] [seed]
+	bool json = argc > 1 && !strcmp(argv[1], "json");
+	if (argc > 1 && !json && strcmp(argv[1], "csv")) {
+		std::cerr << "usage: " << argv[0] << " [csv|json] [repetitions] [seed]" << std::endl;
+		return 1;
+	}
+	int repetitions = argc > 2 ? std::max(1, atoi(argv[2])) : 21;
+	unsigned seed = argc > 3 ? strtoul(argv[3], 0, 0) : 1;
+	std::vector<Measurement> measurements;
+	if (1) {
+		BoseChaudhuriHocquenghem<6, 1, 5, GF::Types<4, 0b10011, uint8_t>> bch({0b10011, 0b11111, 0b00111});
+		benchmark(measurements, "NASA INTRO BCH(15, 5) T=3", bch, 5, 3, 1, repetitions, seed);
+	}
+	if (1) {
+		ReedSolomon<4, 0, GF::Types<4, 0b10011, uint8_t>> rs;
+		benchmark(measurements, "BBC WHP031 RS(15, 11) T=2", rs, 11, 2, 15, repetitions, seed);
+	}
+	if (1) {
+		ReedSolomon<16, 0, GF::Types<8, 0b100011101, uint8_t>> rs;
+		benchmark(measurements, "DVB-T RS(255, 239) T=8", rs, 239, 8, 255, repetitions, seed);
+	}
+	if (1) {
+		ReedSolomon<16, 0, GF::Types<8, 0b100011101, uint8_t>, 204> rs;
+		benchmark(measurements, "DVB-T RS(204, 188) T=8", rs, 188, 8, 255, repetitions, seed);
+	}
+	if (1) {
+		BoseChaudhuriHocquenghem<24, 1, 65343, GF::Types<16, 0b10000000000101101, uint16_t>> bch({0b10000000000101101, 0b10000000101110011, 0b10000111110111101, 0b10101101001010101, 0b10001111100101111, 0b11111011110110101, 0b11010111101100101, 0b10111001101100111, 0b10000111010100001, 0b10111010110100111, 0b10011101000101101, 0b10001101011100011});
+		benchmark(measurements, "DVB-S2 FULL BCH(65535, 65343) T=12", bch, 65343, 12, 1, repetitions, seed);
+	}
+	if (1) {
+		BoseChaudhuriHocquenghem<24, 1, 65343, GF::Types<16, 0b10000000000101101, uint16_t, GF::CarrylessArithmetic>> bch({0b10000000000101101, 0b10000000101110011, 0b10000111110111101, 0b10101101001010101, 0b10001111100101111, 0b11111011110110101, 0b11010111101100101, 0b10111001101100111, 0b10000111010100001, 0b10111010110100111, 0b10011101000101101, 0b10001101011100011});
+		benchmark(measurements, "DVB-S2 FULL BCH(65535, 65343) T=12 CARRYLESS", bch, 65343, 12, 1, repetitions, seed);
+	}
+	if (1) {
+		BoseChaudhuriHocquenghem<24, 1, 58128, GF::Types<16, 0b10000000000101101, uint16_t>, 58320> bch({0b10000000000101101, 0b10000000101110011, 0b10000111110111101, 0b10101101001010101, 0b10001111100101111, 0b11111011110110101, 0b11010111101100101, 0b10111001101100111, 0b10000111010100001, 0b10111010110100111, 0b10011101000101101, 0b10001101011100011});
+		benchmark(measurements, "DVB-S2 NORMAL BCH(58320, 58128) T=12", bch, 58128, 12, 1, repetitions, seed);
+	}
+	if (1) {
+		ReedSolomon<64, 1, GF::Types<16, 0b10001000000001011, uint16_t>> rs;
+		benchmark(measurements, "FUN RS(65535, 65471) T=32", rs, 65471, 32, 65535, repetitions, seed);
+	}
+	if (1) {
+		ReedSolomon<64, 1, GF::Types<16, 0b10001000000001011, uint16_t, GF::CarrylessArithmetic>> rs;
+		benchmark(measurements, "FUN RS(65535, 65471) T=32 CARRYLESS", rs, 65471, 32, 65535, repetitions, seed);
+	}
+	if (json)
+		print_json(measurements);
+	else
+		print_csv(measurements);
+	int failures = 0;
+	for (auto &m: measurements)
+		failures += m.failures;
+	return failures != 0;
+}
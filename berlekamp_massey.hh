@@ -17,7 +17,8 @@ struct BerlekampMassey
 	typedef typename GF::ValueType ValueType;
 	typedef typename GF::IndexType IndexType;
 	static const int N = GF::N, K = N - NR;
-	static int algorithm(ValueType *s, ValueType *C, int count = 0)
+	static const bool EVALUATOR = false;
+	static int algorithm(ValueType *s, ValueType *C, int count = 0, ValueType * = 0)
 	{
 		ValueType B[NR+1];
 		for (int i = 0; i <= NR; ++i)
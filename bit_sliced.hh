@@ -0,0 +1,218 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef BIT_SLICED_HH
+#define BIT_SLICED_HH
+
+#include <cstdint>
+#include <algorithm>
+#include "galois_field.hh"
+
+/*
+Bit-sliced field elements: plane b holds bit b of the symbols of as many independent codewords as WORD has bits.
+Sums are xors of the planes and products are fixed networks of ands and xors, so there are no table lookups at all.
+*/
+template <int M, int POLY, typename WORD>
+struct BitSliced
+{
+	static_assert(M <= 8, "symbols have to fit into bytes");
+	static const int Q = 1 << M, N = Q - 1, LANES = 8 * sizeof(WORD);
+	WORD planes[M];
+	static BitSliced zero()
+	{
+		BitSliced a;
+		for (int b = 0; b < M; ++b)
+			a.planes[b] = 0;
+		return a;
+	}
+	BitSliced operator + (const BitSliced &a) const
+	{
+		BitSliced c;
+		for (int b = 0; b < M; ++b)
+			c.planes[b] = planes[b] ^ a.planes[b];
+		return c;
+	}
+	BitSliced operator * (const BitSliced &a) const
+	{
+		// schoolbook product of the polynomials, then $x^k = x^{k-M} * (POLY - x^M)$ from the top down
+		WORD tmp[2*M-1];
+		for (int k = 0; k < 2*M-1; ++k)
+			tmp[k] = 0;
+		for (int i = 0; i < M; ++i)
+			for (int j = 0; j < M; ++j)
+				tmp[i+j] ^= planes[i] & a.planes[j];
+		for (int k = 2*M-2; k >= M; --k)
+			for (int b = 0; b < M; ++b)
+				if ((POLY >> b) & 1)
+					tmp[k-M+b] ^= tmp[k];
+		BitSliced c;
+		for (int b = 0; b < M; ++b)
+			c.planes[b] = tmp[b];
+		return c;
+	}
+	// the same symbol in every lane
+	static BitSliced broadcast(int value)
+	{
+		BitSliced a;
+		for (int b = 0; b < M; ++b)
+			a.planes[b] = -(WORD)((value >> b) & 1);
+		return a;
+	}
+	// $x_{8i+j} = x_{8j+i}$ for the 8x8 bit matrix with rows in the bytes of x
+	static uint64_t transpose(uint64_t x)
+	{
+		uint64_t t;
+		t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+		x ^= t ^ (t << 7);
+		t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+		x ^= t ^ (t << 14);
+		t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+		x ^= t ^ (t << 28);
+		return x;
+	}
+	// symbol of lane l goes to bit l of the planes, missing lanes are zero
+	static BitSliced gather(const uint8_t *symbols, int stride, int lanes)
+	{
+		// eight lanes at a time, after the transpose byte b holds bit b of their symbols
+		BitSliced a = zero();
+		for (int k = 0; 8 * k < lanes; ++k) {
+			uint64_t x = 0;
+			for (int i = 0; i < 8 && 8 * k + i < lanes; ++i)
+				x |= (uint64_t)symbols[(8*k+i)*stride] << (8 * i);
+			x = transpose(x);
+			for (int b = 0; b < M; ++b)
+				a.planes[b] |= (WORD)((x >> (8 * b)) & 255) << (8 * k);
+		}
+		return a;
+	}
+	void scatter(uint8_t *symbols, int stride, int lanes) const
+	{
+		for (int k = 0; 8 * k < lanes; ++k) {
+			uint64_t x = 0;
+			for (int b = 0; b < M; ++b)
+				x |= (uint64_t)((planes[b] >> (8 * k)) & 255) << (8 * b);
+			x = transpose(x);
+			for (int i = 0; i < 8 && 8 * k + i < lanes; ++i)
+				symbols[(8*k+i)*stride] = (x >> (8 * i)) & 255;
+		}
+	}
+};
+
+// multiplication by a constant is linear over GF(2), bit j of rows[b] says if input bit j adds to output bit b
+template <int M, int POLY, typename WORD>
+struct BitSlicedConstant
+{
+	uint32_t rows[M];
+	BitSlicedConstant() {}
+	template <typename ValueType>
+	explicit BitSlicedConstant(ValueType c)
+	{
+		for (int b = 0; b < M; ++b)
+			rows[b] = 0;
+		for (int j = 0; j < M; ++j) {
+			int column = (int)(c * ValueType(1 << j));
+			for (int b = 0; b < M; ++b)
+				rows[b] |= ((column >> b) & 1) << j;
+		}
+	}
+	BitSliced<M, POLY, WORD> operator * (const BitSliced<M, POLY, WORD> &a) const
+	{
+		BitSliced<M, POLY, WORD> c;
+		for (int b = 0; b < M; ++b) {
+			WORD sum = 0;
+			for (int j = 0; j < M; ++j)
+				sum ^= a.planes[j] & -(WORD)((rows[b] >> j) & 1);
+			c.planes[b] = sum;
+		}
+		return c;
+	}
+};
+
+/*
+Encoding and syndromes of ReedSolomon<NR, FCR, GF, LENGTH> for a whole batch of codewords in lockstep,
+as many at once as WORD has bits, for the small fields where a symbol fits into a byte.
+Codeword i starts at codes + i * N, just like with the BatchDecoder.
+*/
+template <int NR, int FCR, typename GF, int LENGTH = GF::N, typename WORD = uint64_t>
+class BitSlicedReedSolomon
+{
+public:
+	typedef typename GF::value_type value_type;
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	static const int N = LENGTH, K = N - NR;
+	typedef BitSliced<GF::M, GF::POLY, WORD> Sliced;
+	typedef BitSlicedConstant<GF::M, GF::POLY, WORD> Constant;
+	static const int LANES = Sliced::LANES;
+	static_assert(GF::M <= 8 && sizeof(value_type) == 1, "only for symbols fitting into a byte");
+	// $generators_j = generator_{NR-1-j}$ and $roots_i = pe^{FCR+i}$
+	Constant generators[NR], roots[NR];
+	BitSlicedReedSolomon()
+	{
+		// $generator = \prod_{i=0}^{NR}(x-pe^{FCR+i})$, the same as in ReedSolomon
+		ValueType tmp[NR+1];
+		IndexType root(FCR), pe(1);
+		for (int i = 0; i < NR; ++i) {
+			roots[i] = Constant(value(root));
+			tmp[i] = ValueType(1);
+			for (int j = i; j > 0; --j)
+				tmp[j] = fma(root, tmp[j], tmp[j-1]);
+			tmp[0] *= root;
+			root *= pe;
+		}
+		for (int j = 0; j < NR; ++j)
+			generators[j] = Constant(tmp[NR-1-j]);
+	}
+	void encode(value_type *codes, int blocks)
+	{
+		for (int g = 0; g < blocks; g += LANES) {
+			int lanes = std::min(LANES, blocks - g);
+			value_type *group = codes + g * N;
+			// the same shift register as ReedSolomon::encode, with the products computed instead of looked up
+			Sliced tmp[NR];
+			for (int j = 0; j < NR; ++j)
+				tmp[j] = Sliced::zero();
+			for (int i = 0; i < K; ++i) {
+				Sliced feedback = Sliced::gather(group + i, N, lanes) + tmp[0];
+				for (int j = 1; j < NR; ++j)
+					tmp[j-1] = tmp[j] + generators[j-1] * feedback;
+				tmp[NR-1] = generators[NR-1] * feedback;
+			}
+			for (int j = 0; j < NR; ++j)
+				tmp[j].scatter(group + K + j, N, lanes);
+		}
+	}
+	// returns the number of codewords with nonzero syndromes, syndromes of codeword i start at syndromes + i * NR
+	int compute_syndromes(const value_type *codes, value_type *syndromes, int blocks)
+	{
+		int dirty = 0;
+		for (int g = 0; g < blocks; g += LANES) {
+			int lanes = std::min(LANES, blocks - g);
+			const value_type *group = codes + g * N;
+			// $syndromes_i = code(pe^{FCR+i})$ with Horner
+			Sliced sums[NR];
+			for (int i = 0; i < NR; ++i)
+				sums[i] = Sliced::zero();
+			for (int j = 0; j < N; ++j) {
+				Sliced symbol = Sliced::gather(group + j, N, lanes);
+				for (int i = 0; i < NR; ++i)
+					sums[i] = roots[i] * sums[i] + symbol;
+			}
+			WORD nonzero = 0;
+			for (int i = 0; i < NR; ++i) {
+				sums[i].scatter(syndromes + g * NR + i, NR, lanes);
+				for (int b = 0; b < GF::M; ++b)
+					nonzero |= sums[i].planes[b];
+			}
+			for (int l = 0; l < lanes; ++l)
+				dirty += (nonzero >> l) & 1;
+		}
+		return dirty;
+	}
+};
+
+#endif
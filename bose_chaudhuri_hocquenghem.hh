@@ -8,19 +8,33 @@ You should have received a copy of the CC0 Public Domain Dedication along with t
 #ifndef BOSE_CHAUDHURI_HOCQUENGHEM_HH
 #define BOSE_CHAUDHURI_HOCQUENGHEM_HH
 
+#include <cstdint>
 #include <initializer_list>
 #include "galois_field.hh"
 #include "correction.hh"
+#include "constant_time_correction.hh"
+#include "syndromes.hh"
+#include "parallel_decoding.hh"
+#include "decoder_stats.hh"
 
-template <int NR, int FCR, int K, typename GF>
+template <int NR, int FCR, int K, typename GF, int LENGTH = GF::N, template <int, typename> class SOLVER = BerlekampMassey>
 class BoseChaudhuriHocquenghem
 {
 public:
 	typedef typename GF::value_type value_type;
 	typedef typename GF::ValueType ValueType;
 	typedef typename GF::IndexType IndexType;
-	static const int N = GF::N, NP = N - K;
+	// shortened codes omit the first SHORTENED symbols, which are implicitly zero
+	static const int N = LENGTH, NP = N - K, SHORTENED = GF::N - N, WORDS = (NP + 63) / 64;
+	// the lfsr eats a byte of bits in a few nanoseconds, so a range has to be long to pay for waking a thread
+	static const int MIN_RANGE = 16384;
+	static_assert(K < N && N <= GF::N, "LENGTH out of range");
 	ValueType generator[NP+1];
+	// bit i of the lfsr register holds $code_{K+i}$
+	uint64_t lfsr_generator[WORDS];
+	uint64_t lfsr_table[256][WORDS];
+	// $syndrome_table_{i,byte} = \sum_{b=0}^{7} byte_b\,pe^{(FCR+i)(7-b)}$
+	ValueType syndrome_table[NR][256];
 	BoseChaudhuriHocquenghem(std::initializer_list<int> minimal_polynomials)
 	{
 		// $generator(x) = \prod_i(minpoly_i(x))$
@@ -58,41 +72,174 @@ public:
 			std::cout << " " << (int)generator[i];
 		std::cout << std::endl;
 #endif
-	}
-	void encode(ValueType *code)
-	{
-		// $code = data * x^{NP} + (data * x^{NP}) \mod{generator}$
+		for (int i = 0; i < WORDS; ++i)
+			lfsr_generator[i] = 0;
 		for (int i = 0; i < NP; ++i)
-			code[K+i] = ValueType(0);
-		for (int i = 0; i < K; ++i) {
-			if (code[i] != code[K]) {
-				for (int j = 1; j < NP; ++j)
-					code[K+j-1] = generator[NP-j] + code[K+j];
-				code[N-1] = generator[0];
-			} else {
-				for (int j = 1; j < NP; ++j)
-					code[K+j-1] = code[K+j];
-				code[N-1] = ValueType(0);
+			lfsr_generator[i/64] |= (uint64_t)(int)generator[NP-1-i] << (i%64);
+		for (int byte = 0; byte < 256; ++byte) {
+			uint64_t *reg = lfsr_table[byte];
+			for (int i = 0; i < WORDS; ++i)
+				reg[i] = 0;
+			reg[0] = byte;
+			for (int b = 0; b < 8; ++b)
+				lfsr_bit(reg, 0);
+		}
+		for (int i = 0; i < NR; ++i) {
+			IndexType root((FCR + i) % GF::N);
+			for (int byte = 0; byte < 256; ++byte) {
+				ValueType sum(0);
+				for (int b = 0; b < 8; ++b)
+					sum = fma(root, sum, ValueType((byte >> b) & 1));
+				syndrome_table[i][byte] = sum;
 			}
 		}
 	}
-	int compute_syndromes(ValueType *code, ValueType *syndromes)
+	void lfsr_bit(uint64_t *reg, int bit)
 	{
-		// $syndromes_i = code(pe^{FCR+i})$
-		for (int i = 0; i < NR; ++i)
-			syndromes[i] = code[0];
-		for (int j = 1; j < N; ++j) {
-			IndexType root(FCR), pe(1);
-			for (int i = 0; i < NR; ++i) {
-				syndromes[i] = fma(root, syndromes[i], code[j]);
-				root *= pe;
+		uint64_t feedback = -((reg[0] ^ bit) & 1);
+		for (int i = 0; i < WORDS - 1; ++i)
+			reg[i] = ((reg[i] >> 1) | (reg[i+1] << 63)) ^ (feedback & lfsr_generator[i]);
+		reg[WORDS-1] = (reg[WORDS-1] >> 1) ^ (feedback & lfsr_generator[WORDS-1]);
+	}
+	void lfsr_byte(uint64_t *reg, int byte)
+	{
+		if (NP < 8) {
+			for (int b = 0; b < 8; ++b)
+				lfsr_bit(reg, (byte >> b) & 1);
+			return;
+		}
+		// $reg = reg \cdot x^8 + byte \cdot x^{NP+8} \mod{generator}$ in eight bits per step
+		const uint64_t *row = lfsr_table[(reg[0] ^ byte) & 255];
+		for (int i = 0; i < WORDS - 1; ++i)
+			reg[i] = ((reg[i] >> 8) | (reg[i+1] << 56)) ^ row[i];
+		reg[WORDS-1] = (reg[WORDS-1] >> 8) ^ row[WORDS-1];
+	}
+	int syndromes_remainder(const uint64_t *reg, ValueType *syndromes)
+	{
+		// every root of the generator is also a root of the minimal polynomial it came from,
+		// so the syndromes of the code are those of its remainder, which has only NP bits.
+		// For binary codes $code(x^2) = code(x)^2$, so the even powers are squares of earlier syndromes
+		for (int i = 0; i < NR; ++i) {
+			int exponent = FCR + i;
+			if (exponent > 0 && !(exponent & 1) && exponent / 2 >= FCR) {
+				ValueType tmp(syndromes[exponent/2-FCR]);
+				syndromes[i] = tmp * tmp;
+				continue;
 			}
+			IndexType root(exponent % GF::N), root8(8 * exponent % GF::N);
+			ValueType sum(0);
+			// bit j of the register holds the coefficient of $x^{NP-1-j}$
+			for (int j = 0; j < NP / 8; ++j)
+				sum = fma(root8, sum, syndrome_table[i][(reg[j/8] >> (8*(j%8))) & 255]);
+			for (int j = NP & ~7; j < NP; ++j)
+				sum = fma(root, sum, ValueType((reg[j/64] >> (j%64)) & 1));
+			syndromes[i] = sum;
 		}
 		int nonzero = 0;
 		for (int i = 0; i < NR; ++i)
 			nonzero += !!syndromes[i];
 		return nonzero;
 	}
+	void remainder(const ValueType *data, uint64_t *reg, int length = K)
+	{
+		// $reg = (data * x^{NP}) \mod{generator}$ for the first length symbols of data
+		for (int i = 0; i < WORDS; ++i)
+			reg[i] = 0;
+		for (int i = 0; i + 8 <= length; i += 8) {
+			int byte = 0;
+			for (int b = 0; b < 8; ++b)
+				byte |= (int)data[i+b] << b;
+			lfsr_byte(reg, byte);
+		}
+		for (int i = length & ~7; i < length; ++i)
+			lfsr_bit(reg, (int)data[i]);
+	}
+	void remainder_packed(const uint8_t *data, uint64_t *reg)
+	{
+		// bit b of byte i is $code_{8i+b}$
+		for (int i = 0; i < WORDS; ++i)
+			reg[i] = 0;
+		for (int i = 0; i < K / 8; ++i)
+			lfsr_byte(reg, data[i]);
+		for (int i = K & ~7; i < K; ++i)
+			lfsr_bit(reg, (data[i/8] >> (i%8)) & 1);
+	}
+	void encode(ValueType *code)
+	{
+		// $code = data * x^{NP} + (data * x^{NP}) \mod{generator}$
+		uint64_t reg[WORDS];
+		remainder(code, reg);
+		for (int i = 0; i < NP; ++i)
+			code[K+i] = ValueType((reg[i/64] >> (i%64)) & 1);
+	}
+	bool check(const ValueType *code)
+	{
+		// clean codewords reproduce their parity, which is cheaper than NR syndromes
+		uint64_t reg[WORDS];
+		remainder(code, reg);
+		for (int i = 0; i < NP; ++i)
+			reg[i/64] ^= (uint64_t)(int)code[K+i] << (i%64);
+		uint64_t diff = 0;
+		for (int i = 0; i < WORDS; ++i)
+			diff |= reg[i];
+		return !diff;
+	}
+	void encode_packed(const uint8_t *data, uint8_t *parity)
+	{
+		uint64_t reg[WORDS];
+		remainder_packed(data, reg);
+		for (int i = 0; i < (NP + 7) / 8; ++i)
+			parity[i] = reg[i/8] >> (8*(i%8));
+	}
+	int compute_syndromes(ValueType *code, ValueType *syndromes)
+	{
+		DECODER_STATS_STAGE(SYNDROMES);
+		// $code \bmod{generator} = (data * x^{NP}) \bmod{generator} + parity$
+		uint64_t reg[WORDS];
+		remainder(code, reg);
+		for (int i = 0; i < NP; ++i)
+			reg[i/64] ^= (uint64_t)(int)code[K+i] << (i%64);
+		return syndromes_remainder(reg, syndromes);
+	}
+private:
+	// applies the corrections the syndromes ask for through flip(position), which toggles that bit of the codeword,
+	// if track is set the syndromes follow along, so they still belong to the code afterwards
+	template <typename FLIP, typename SEARCH>
+	int correct(ValueType *syndromes, IndexType *erasures, int erasures_count, bool track, FLIP flip, SEARCH search)
+	{
+		IndexType locations[NR];
+		ValueType magnitudes[NR];
+		int count = Correction<NR, FCR, GF, SOLVER>::algorithm(syndromes, locations, magnitudes, erasures, erasures_count, SHORTENED, search);
+		if (count <= 0) {
+			DECODER_STATS_OUTCOME(count);
+			return count;
+		}
+		for (int i = 0; i < count; ++i)
+			if (1 < (int)magnitudes[i]) {
+				DECODER_STATS_OUTCOME(-1);
+				return -1;
+			}
+		int corrections_count = 0;
+		for (int i = 0; i < count; ++i) {
+			if (!magnitudes[i])
+				continue;
+			flip((int)locations[i]);
+			if (track)
+				update_syndromes(syndromes, (int)locations[i], magnitudes[i]);
+			++corrections_count;
+		}
+		DECODER_STATS_OUTCOME(corrections_count);
+		return corrections_count;
+	}
+	int correct(ValueType *code, ValueType *syndromes, IndexType *erasures, int erasures_count, bool track = false)
+	{
+		return correct(syndromes, erasures, erasures_count, track,
+			[code](int position) {
+				code[position] += ValueType(1);
+			},
+			FindLocations<NR, GF>::search);
+	}
+public:
 	int decode(ValueType *code, IndexType *erasures = 0, int erasures_count = 0)
 	{
 		assert(0 <= erasures_count && erasures_count <= NR);
@@ -101,22 +248,129 @@ public:
 			code[(int)erasures[i]] = ValueType(0);
 #endif
 		ValueType syndromes[NR];
-		if (!compute_syndromes(code, syndromes))
+		if (!compute_syndromes(code, syndromes)) {
+			DECODER_STATS_OUTCOME(0);
 			return 0;
+		}
+		return correct(code, syndromes, erasures, erasures_count);
+	}
+	int decode_constant_time(ValueType *code, IndexType *erasures = 0, int erasures_count = 0)
+	{
+		// same work for every block, no matter if it is clean or how many errors it has
+		ValueType syndromes[NR];
+		compute_syndromes(code, syndromes);
 		IndexType locations[NR];
 		ValueType magnitudes[NR];
-		int count = Correction<NR, FCR, GF>::algorithm(syndromes, locations, magnitudes, erasures, erasures_count);
-		if (count <= 0)
-			return count;
-		for (int i = 0; i < count; ++i)
-			if (1 < (int)magnitudes[i])
-				return -1;
-		for (int i = 0; i < count; ++i)
-			code[(int)locations[i]] += magnitudes[i];
+		int count = ConstantTimeCorrection<NR, FCR, GF>::algorithm(syndromes, locations, magnitudes, erasures, erasures_count, SHORTENED);
+		int invalid = count < 0;
+		for (int i = 0; i < NR; ++i)
+			invalid |= 1 < (int)magnitudes[i];
 		int corrections_count = 0;
-		for (int i = 0; i < count; ++i)
-			corrections_count += !!magnitudes[i];
-		return corrections_count;
+		for (int i = 0; i < NR; ++i) {
+			ValueType magnitude(invalid ? ValueType(0) : magnitudes[i]);
+			code[(int)locations[i]] += magnitude;
+			corrections_count += !!magnitude;
+		}
+		DECODER_STATS_OUTCOME(invalid ? -1 : corrections_count);
+		return invalid ? -1 : corrections_count;
+	}
+	int decode_fast(ValueType *code, IndexType *erasures = 0, int erasures_count = 0)
+	{
+		if (check(code)) {
+			DECODER_STATS_OUTCOME(0);
+			return 0;
+		}
+		return decode(code, erasures, erasures_count);
+	}
+	int compute_syndromes_parallel(ValueType *code, ValueType *syndromes, ThreadPool &pool)
+	{
+		DECODER_STATS_STAGE(SYNDROMES);
+		// the remainder of a range gives the syndromes of its chunk times $root^{NP}$,
+		// so each thread runs the same lfsr as compute_syndromes, just over fewer bits
+		return ParallelDecoding<NR, FCR, GF>::syndromes(pool, syndromes, N, MIN_RANGE, NP,
+			[this, code](int begin, int end, ValueType *partial) {
+				uint64_t reg[WORDS];
+				remainder(code + begin, reg, end - begin);
+				syndromes_remainder(reg, partial);
+			});
+	}
+	int decode_parallel(ValueType *code, ThreadPool &pool, IndexType *erasures = 0, int erasures_count = 0)
+	{
+		// same as decode, but the syndromes and the Chien search of this single codeword are spread over the pool
+		assert(0 <= erasures_count && erasures_count <= NR);
+		ValueType syndromes[NR];
+		if (!compute_syndromes_parallel(code, syndromes, pool)) {
+			DECODER_STATS_OUTCOME(0);
+			return 0;
+		}
+		return correct(syndromes, erasures, erasures_count, false,
+			[code](int position) {
+				code[position] += ValueType(1);
+			},
+			[&pool](ValueType *locator, int locator_degree, IndexType *locations, int first) {
+				return ParallelDecoding<NR, FCR, GF>::search(pool, locator, locator_degree, locations, first);
+			});
+	}
+	// $syndromes_i$ += $delta\,pe^{(FCR+i)(N-1-position)}$, as code[position] holds the coefficient of $x^{N-1-position}$
+	void update_syndromes(ValueType *syndromes, int position, ValueType delta)
+	{
+		assert(0 <= position && position < N);
+		assert((int)delta < 2);
+		if (!delta)
+			return;
+		int exponent = N - 1 - position;
+		IndexType step(exponent), term((long long)FCR * exponent % GF::N);
+		for (int i = 0; i < NR; ++i, term *= step)
+			syndromes[i] += value(term);
+	}
+	// puts bit at code[position] and keeps the syndromes of code up to date in $O(NR)$
+	void replace_symbol(ValueType *code, ValueType *syndromes, int position, ValueType bit)
+	{
+		update_syndromes(syndromes, position, code[position] + bit);
+		code[position] = bit;
+	}
+	/*
+	Same as decode, but starts from syndromes that already belong to code,
+	e.g. kept up to date with replace_symbol while a failed block gets repaired piece by piece.
+	On success the syndromes follow the corrections, so they stay valid for the next attempt.
+	*/
+	int decode_syndromes(ValueType *code, ValueType *syndromes, IndexType *erasures = 0, int erasures_count = 0)
+	{
+		assert(0 <= erasures_count && erasures_count <= NR);
+		int nonzero = 0;
+		for (int i = 0; i < NR; ++i)
+			nonzero |= !!syndromes[i];
+		if (!nonzero) {
+			DECODER_STATS_OUTCOME(0);
+			return 0;
+		}
+		return correct(code, syndromes, erasures, erasures_count, true);
+	}
+	int compute_syndromes_packed(const uint8_t *data, const uint8_t *parity, ValueType *syndromes)
+	{
+		DECODER_STATS_STAGE(SYNDROMES);
+		uint64_t reg[WORDS];
+		remainder_packed(data, reg);
+		for (int i = 0; i < NP; ++i)
+			reg[i/64] ^= (uint64_t)((parity[i/8] >> (i%8)) & 1) << (i%64);
+		return syndromes_remainder(reg, syndromes);
+	}
+	int decode_packed(uint8_t *data, uint8_t *parity, IndexType *erasures = 0, int erasures_count = 0)
+	{
+		assert(0 <= erasures_count && erasures_count <= NR);
+		ValueType syndromes[NR];
+		if (!compute_syndromes_packed(data, parity, syndromes)) {
+			DECODER_STATS_OUTCOME(0);
+			return 0;
+		}
+		return correct(syndromes, erasures, erasures_count, false,
+			[data, parity](int pos) {
+				if (pos < K)
+					data[pos/8] ^= 1 << (pos%8);
+				else
+					parity[(pos-K)/8] ^= 1 << ((pos-K)%8);
+			},
+			FindLocations<NR, GF>::search);
 	}
 	void encode(value_type *code)
 	{
@@ -126,10 +380,50 @@ public:
 	{
 		return decode(reinterpret_cast<ValueType *>(code), reinterpret_cast<IndexType *>(erasures), erasures_count);
 	}
+	bool check(const value_type *code)
+	{
+		return check(reinterpret_cast<const ValueType *>(code));
+	}
+	int decode_constant_time(value_type *code, value_type *erasures = 0, int erasures_count = 0)
+	{
+		return decode_constant_time(reinterpret_cast<ValueType *>(code), reinterpret_cast<IndexType *>(erasures), erasures_count);
+	}
+	int decode_fast(value_type *code, value_type *erasures = 0, int erasures_count = 0)
+	{
+		return decode_fast(reinterpret_cast<ValueType *>(code), reinterpret_cast<IndexType *>(erasures), erasures_count);
+	}
+	int decode_parallel(value_type *code, ThreadPool &pool, value_type *erasures = 0, int erasures_count = 0)
+	{
+		return decode_parallel(reinterpret_cast<ValueType *>(code), pool, reinterpret_cast<IndexType *>(erasures), erasures_count);
+	}
+	int compute_syndromes_parallel(value_type *code, value_type *syndromes, ThreadPool &pool)
+	{
+		return compute_syndromes_parallel(reinterpret_cast<ValueType *>(code), reinterpret_cast<ValueType *>(syndromes), pool);
+	}
 	int compute_syndromes(value_type *code, value_type *syndromes)
 	{
 		return compute_syndromes(reinterpret_cast<ValueType *>(code), reinterpret_cast<ValueType *>(syndromes));
 	}
+	void update_syndromes(value_type *syndromes, int position, value_type delta)
+	{
+		update_syndromes(reinterpret_cast<ValueType *>(syndromes), position, ValueType(delta));
+	}
+	void replace_symbol(value_type *code, value_type *syndromes, int position, value_type bit)
+	{
+		replace_symbol(reinterpret_cast<ValueType *>(code), reinterpret_cast<ValueType *>(syndromes), position, ValueType(bit));
+	}
+	int decode_syndromes(value_type *code, value_type *syndromes, value_type *erasures = 0, int erasures_count = 0)
+	{
+		return decode_syndromes(reinterpret_cast<ValueType *>(code), reinterpret_cast<ValueType *>(syndromes), reinterpret_cast<IndexType *>(erasures), erasures_count);
+	}
+	int decode_packed(uint8_t *data, uint8_t *parity, value_type *erasures, int erasures_count)
+	{
+		return decode_packed(data, parity, reinterpret_cast<IndexType *>(erasures), erasures_count);
+	}
+	int compute_syndromes_packed(const uint8_t *data, const uint8_t *parity, value_type *syndromes)
+	{
+		return compute_syndromes_packed(data, parity, reinterpret_cast<ValueType *>(syndromes));
+	}
 };
 
 #endif
@@ -8,7 +8,9 @@ You should have received a copy of the CC0 Public Domain Dedication along with t
 #ifndef CHIEN_HH
 #define CHIEN_HH
 
+#include <type_traits>
 #include "galois_field.hh"
+#include "gfni.hh"
 
 template <int NR, typename GF>
 struct Chien
@@ -16,19 +18,95 @@ struct Chien
 	typedef typename GF::value_type value_type;
 	typedef typename GF::ValueType ValueType;
 	typedef typename GF::IndexType IndexType;
-	static const int N = GF::N, K = N - NR;
-	static int search(ValueType *locator, int locator_degree, IndexType *locations)
+	static const int N = GF::N, K = N - NR, LANES = 16;
+#ifdef GFNI_KERNELS
+	struct Affine
 	{
-		ValueType tmp[locator_degree+1];
-		for (int i = 0; i <= locator_degree; ++i)
-			tmp[i] = locator[i];
+		static const int W = 64;
+		bool supported;
+		// $powers_{k,l} = pe^{kl}$ and $steps_k$ is the matrix of $pe^{kW}$
+		uint8_t powers[NR+1][W];
+		uint64_t steps[NR+1];
+		Affine() : supported(GaloisFieldNewInstructions::supported())
+		{
+			for (int k = 0; k <= NR; ++k) {
+				for (int l = 0; l < W; ++l)
+					powers[k][l] = (int)value(IndexType((long long)k * l % N));
+				steps[k] = GaloisFieldNewInstructions::multiply<GF::M>(value(IndexType((long long)k * W % N)));
+			}
+		}
+	};
+	static int search(ValueType *locator, int locator_degree, IndexType *locations, int first, int last, std::true_type)
+	{
+		static const Affine affine;
+		if (!affine.supported)
+			return search(locator, locator_degree, locations, first, last, std::false_type());
+		// lane l of the term of $x^k$ starts at $locator_k\,pe^{k(first+l+1)}$
+		uint64_t scales[NR+1];
+		for (int k = 1; k <= locator_degree; ++k)
+			scales[k] = GaloisFieldNewInstructions::multiply<GF::M>(locator[k] * IndexType((long long)k * (first + 1) % N));
+		uint8_t terms[NR * Affine::W];
+		uint64_t roots[(N + Affine::W - 1) / Affine::W];
+		GaloisFieldNewInstructions::chien(affine.powers[1], scales + 1, affine.steps + 1, terms, locator_degree, (int)locator[0], last - first, roots);
 		int count = 0;
-		for (int i = 0; i < N; ++i) {
-			ValueType sum(tmp[0]);
-			for (int j = 1; j <= locator_degree; ++j)
-				sum += tmp[j] *= IndexType(j);
-			if (!sum)
+		for (int s = 0; first + s * Affine::W < last; ++s) {
+			for (uint64_t mask = roots[s]; mask; mask &= mask - 1) {
+				int i = first + s * Affine::W + __builtin_ctzll(mask);
+				if (i >= last)
+					break;
 				locations[count++] = IndexType(i);
+				if (count == locator_degree)
+					return count;
+			}
+		}
+		return count;
+	}
+#endif
+	static int search(ValueType *locator, int locator_degree, IndexType *locations, int first = 0, int last = N)
+	{
+#ifdef GFNI_KERNELS
+		return search(locator, locator_degree, locations, first, last, std::integral_constant<bool, GF::M <= 8 && sizeof(value_type) == 1>());
+#else
+		return search(locator, locator_degree, locations, first, last, std::false_type());
+#endif
+	}
+	static int search(ValueType *locator, int locator_degree, IndexType *locations, int first, int last, std::false_type)
+	{
+		// positions outside [first, last) are not searched, e.g. the implicit zeros of a shortened code
+		// lane l evaluates position i+l, so $exponents_{t,l} = \log(locator_j) + j(i+l+1)$
+		int exponents[locator_degree][LANES], steps[locator_degree];
+		int terms = 0;
+		for (int j = 1; j <= locator_degree; ++j) {
+			if (!locator[j])
+				continue;
+			int exponent = (locator[j].exponent() + j * (first + 1) % N) % N, step = j % N;
+			for (int l = 0; l < LANES; ++l) {
+				exponents[terms][l] = exponent;
+				exponent += step;
+				exponent = exponent < N ? exponent : exponent - N;
+			}
+			steps[terms++] = j * LANES % N;
+		}
+		int count = 0;
+		for (int i = first; i < last; i += LANES) {
+			ValueType sums[LANES];
+			for (int l = 0; l < LANES; ++l)
+				sums[l] = locator[0];
+			for (int t = 0; t < terms; ++t) {
+				for (int l = 0; l < LANES; ++l) {
+					sums[l] += ValueType::power(exponents[t][l]);
+					int tmp = exponents[t][l] + steps[t];
+					exponents[t][l] = tmp < N ? tmp : tmp - N;
+				}
+			}
+			// a polynomial has no more roots than its degree
+			for (int l = 0; l < LANES && i + l < last; ++l) {
+				if (!sums[l]) {
+					locations[count++] = IndexType(i + l);
+					if (count == locator_degree)
+						return count;
+				}
+			}
 		}
 		return count;
 	}
@@ -0,0 +1,122 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef CONSTANT_TIME_CORRECTION_HH
+#define CONSTANT_TIME_CORRECTION_HH
+
+#include <algorithm>
+#include "galois_field.hh"
+#include "reformulated_berlekamp_massey.hh"
+
+/*
+Same interface as Correction, but the same work for every block of a code:
+all NR erasure slots, all NR steps of the key equation, all positions of the code and all NR magnitudes.
+Unused slots of locations and magnitudes are set to zero, so they can be applied unconditionally.
+*/
+template <int NR, int FCR, typename GF>
+struct ConstantTimeCorrection
+{
+	typedef typename GF::value_type value_type;
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	static const int N = GF::N, K = N - NR, ZERO = 2 * N, LANES = 16;
+	static int search(ValueType *locator, int *positions, int first)
+	{
+		// Chien search over all positions and all coefficients, zero coefficients included
+		int exponents[NR+1], powers[NR+1][LANES], steps[NR+1];
+		for (int j = 0; j <= NR; ++j) {
+			exponents[j] = locator[j].exponent();
+			int power = j * (first + 1) % N, step = j % N;
+			for (int l = 0; l < LANES; ++l) {
+				powers[j][l] = power;
+				power += step;
+				power = power < N ? power : power - N;
+			}
+			steps[j] = j * LANES % N;
+		}
+		for (int i = 0; i <= NR; ++i)
+			positions[i] = first;
+		int count = 0;
+		for (int i = first; i < N; i += LANES) {
+			ValueType sums[LANES];
+			for (int l = 0; l < LANES; ++l)
+				sums[l] = ValueType(0);
+			for (int j = 0; j <= NR; ++j) {
+				for (int l = 0; l < LANES; ++l) {
+					sums[l] += ValueType::power(exponents[j] + powers[j][l]);
+					int tmp = powers[j][l] + steps[j];
+					powers[j][l] = tmp < N ? tmp : tmp - N;
+				}
+			}
+			// every position is written to the next free slot, but only roots advance it
+			for (int l = 0; l < LANES; ++l) {
+				positions[std::min(count, NR)] = i + l;
+				count += !sums[l] & (i + l < N);
+			}
+		}
+		return count;
+	}
+	static int algorithm(ValueType *syndromes, IndexType *locations, ValueType *magnitudes, IndexType *erasures = 0, int erasures_count = 0, int first = 0)
+	{
+		assert(0 <= erasures_count && erasures_count <= NR);
+		assert(0 <= first && first < N);
+		// $locator = \prod_{i=0}^{NR}(1-x\,pe^{N-1-erasures_i})$ with ones for the unused slots
+		ValueType locator[NR+1], evaluator[NR];
+		locator[0] = ValueType(1);
+		for (int i = 1; i <= NR; ++i)
+			locator[i] = ValueType(0);
+		for (int i = 0; i < NR; ++i) {
+			int exponent = i < erasures_count ? N - 1 - ((int)erasures[i] + first) : ZERO;
+			for (int j = i; j >= 0; --j)
+				locator[j+1] += ValueType::power(exponent + locator[j].exponent());
+		}
+		ReformulatedBerlekampMassey<NR, GF>::algorithm(syndromes, locator, evaluator, erasures_count);
+		int degree = 0;
+		for (int i = 1; i <= NR; ++i)
+			degree = locator[i] ? i : degree;
+		int positions[NR+1];
+		int count = search(locator, positions, first);
+		// $magnitude = root^{FCR-1+NR} * \frac{evaluator_h(root)}{locator'(root)}$ for all NR slots
+		int roots[NR], powers[NR], evals[NR], derivs[NR];
+		for (int i = 0; i < NR; ++i) {
+			roots[i] = positions[i] + 1 < N ? positions[i] + 1 : 0;
+			powers[i] = 0;
+			evals[i] = derivs[i] = 0;
+		}
+		for (int j = 0; j < NR; ++j) {
+			int coefficient = evaluator[j].exponent();
+			for (int i = 0; i < NR; ++i) {
+				evals[i] ^= (int)ValueType::power(coefficient + powers[i]);
+				int tmp = powers[i] + roots[i];
+				powers[i] = tmp < N ? tmp : tmp - N;
+			}
+		}
+		for (int i = 0; i < NR; ++i)
+			powers[i] = 0;
+		for (int j = 1; j <= NR; j += 2) {
+			int coefficient = locator[j].exponent();
+			for (int i = 0; i < NR; ++i) {
+				derivs[i] ^= (int)ValueType::power(coefficient + powers[i]);
+				int tmp = powers[i] + 2 * roots[i] % N;
+				powers[i] = tmp < N ? tmp : tmp - N;
+			}
+		}
+		const int SHIFT = ((FCR - 1 + NR) % N + N) % N;
+		for (int i = 0; i < NR; ++i) {
+			int eval = ValueType(evals[i]).exponent(), deriv = ValueType(derivs[i]).exponent();
+			int exponent = eval + N - (deriv < N ? deriv : 0);
+			exponent = exponent < N ? exponent : exponent - N;
+			exponent += (long long)SHIFT * roots[i] % N;
+			int used = -((i < count) & (eval < N) & (deriv < N));
+			magnitudes[i] = ValueType::power((exponent & used) | (ZERO & ~used));
+			locations[i] = IndexType(i < count ? positions[i] - first : 0);
+		}
+		return count == degree ? count : -1;
+	}
+};
+
+#endif
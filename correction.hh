@@ -10,43 +10,103 @@ You should have received a copy of the CC0 Public Domain Dedication along with t
 
 #include "galois_field.hh"
 #include "berlekamp_massey.hh"
+#include "inversionless_berlekamp_massey.hh"
+#include "euclidean.hh"
 #include "find_locations.hh"
 #include "forney.hh"
+#include "decoder_stats.hh"
 
-template <int NR, int FCR, typename GF>
+// SOLVER finds the locator of the key equation, solvers with EVALUATOR also return the evaluator
+template <int NR, int FCR, typename GF, template <int, typename> class SOLVER = BerlekampMassey>
 struct Correction
 {
 	typedef typename GF::value_type value_type;
 	typedef typename GF::ValueType ValueType;
 	typedef typename GF::IndexType IndexType;
 	static const int N = GF::N, K = N - NR;
-	static int algorithm(ValueType *syndromes, IndexType *locations, ValueType *magnitudes, IndexType *erasures = 0, int erasures_count = 0)
+	static int algorithm(ValueType *syndromes, IndexType *locations, ValueType *magnitudes, IndexType *erasures = 0, int erasures_count = 0, int first = 0)
 	{
+		return algorithm(syndromes, locations, magnitudes, erasures, erasures_count, first, FindLocations<NR, GF>::search);
+	}
+	// the locations are known when the syndromes are explained by the erasures alone,
+	// that is when $(syndromes * locator) \bmod{x^{NR}}$ has a degree below their count,
+	// so there is nothing left to find for the key equation and the search,
+	// kept out of line so it does not bloat the common path
+	__attribute__((noinline))
+	static int erasures_only(ValueType *syndromes, ValueType *locator, IndexType *locations, ValueType *magnitudes, IndexType *erasures, int erasures_count, int first)
+	{
+		DECODER_STATS_STAGE(FORNEY);
+		// errors besides the erasures show up in the upper coefficients, so these are checked first
+		for (int i = erasures_count; i < NR; ++i) {
+			ValueType tmp(syndromes[i]);
+			for (int j = 1; j <= erasures_count; ++j)
+				tmp += syndromes[i-j] * locator[j];
+			if (tmp)
+				return -1;
+		}
+		ValueType evaluator[NR];
+		int evaluator_degree = Forney<NR, FCR, GF>::compute_evaluator(syndromes, locator, erasures_count-1, evaluator);
+		for (int i = 0; i < erasures_count; ++i)
+			locations[i] = IndexType((int)erasures[i] + first);
+		Forney<NR, FCR, GF>::compute_magnitudes(locator, locations, erasures_count, evaluator, evaluator_degree, magnitudes);
+		for (int i = 0; i < erasures_count; ++i)
+			locations[i] = erasures[i];
+		return erasures_count;
+	}
+	// search(locator, locator_degree, locations, first) finds the roots of the locator
+	template <typename SEARCH>
+	static int algorithm(ValueType *syndromes, IndexType *locations, ValueType *magnitudes, IndexType *erasures, int erasures_count, int first, SEARCH search)
+	{
+		// erasures and locations of a shortened code are counted from position first
 		assert(0 <= erasures_count && erasures_count <= NR);
+		assert(0 <= first && first < N);
 		ValueType locator[NR+1];
 		locator[0] = ValueType(1);
 		for (int i = 1; i <= NR; ++i)
 			locator[i] = ValueType(0);
 		// $locator = \prod_{i=0}^{count}(1-x\,pe^{N-1-erasures_i})$
 		if (erasures_count)
-			locator[1] = value(IndexType(N-1) / erasures[0]);
+			locator[1] = value(IndexType(N-1) / IndexType((int)erasures[0] + first));
 		for (int i = 1; i < erasures_count; ++i) {
-			IndexType tmp(IndexType(N-1) / erasures[i]);
+			IndexType tmp(IndexType(N-1) / IndexType((int)erasures[i] + first));
 			for (int j = i; j >= 0; --j)
 				locator[j+1] += tmp * locator[j];
 		}
-		int locator_degree = BerlekampMassey<NR, GF>::algorithm(syndromes, locator, erasures_count);
+		if (erasures_count) {
+			int count = erasures_only(syndromes, locator, locations, magnitudes, erasures, erasures_count, first);
+			if (count >= 0)
+				return count;
+		}
+		ValueType evaluator[NR];
+		int locator_degree;
+		{
+			DECODER_STATS_STAGE(KEY_EQUATION);
+			locator_degree = SOLVER<NR, GF>::algorithm(syndromes, locator, erasures_count, evaluator);
+		}
+		if (locator_degree < 0)
+			return -1;
 		assert(locator_degree);
 		assert(locator_degree <= NR);
 		assert(locator[0] == ValueType(1));
 		while (!locator[locator_degree])
 			if (--locator_degree < 0)
 				return -1;
-		int count = FindLocations<NR, GF>::search(locator, locator_degree, locations);
-		if (count < locator_degree)
+		int count = search(locator, locator_degree, locations, first);
+		// the roots never outnumber the degree, checking it lets the compiler see that the loops below stay within NR
+		if (count < locator_degree || count > NR)
 			return -1;
-		ValueType evaluator[NR];
-		int evaluator_degree = Forney<NR, FCR, GF>::algorithm(syndromes, locator, locations, count, evaluator, magnitudes);
+		int evaluator_degree = NR - 1;
+		{
+			DECODER_STATS_STAGE(FORNEY);
+			if (SOLVER<NR, GF>::EVALUATOR)
+				while (evaluator_degree >= 0 && !evaluator[evaluator_degree])
+					--evaluator_degree;
+			else
+				evaluator_degree = Forney<NR, FCR, GF>::compute_evaluator(syndromes, locator, count, evaluator);
+			Forney<NR, FCR, GF>::compute_magnitudes(locator, locations, count, evaluator, evaluator_degree, magnitudes);
+		}
+		for (int i = 0; i < count; ++i)
+			locations[i] = IndexType((int)locations[i] - first);
 #ifdef NDEBUG
 		(void)evaluator_degree;
 #else
@@ -0,0 +1,113 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef DECODER_STATS_HH
+#define DECODER_STATS_HH
+
+#include <cstdint>
+
+/*
+Per stage call counts and clock ticks of the decoders, plus their outcomes.
+Only compiled in with -DDECODER_STATS, otherwise the macros below expand to nothing.
+Ticks come from rdtsc on x86 and from steady_clock in nanoseconds elsewhere.
+*/
+struct DecoderStats
+{
+	enum Stage { SYNDROMES, KEY_EQUATION, DEGREE1, DEGREE2, CUBIC, QUARTIC, CHIEN, FORNEY, STAGES };
+	enum Outcome { CLEAN, CORRECTED, FAILED, OUTCOMES };
+	uint64_t calls[STAGES], ticks[STAGES], outcomes[OUTCOMES];
+	static const char *name(int stage)
+	{
+		static const char *names[STAGES] = { "syndromes", "key equation", "degree 1", "degree 2", "cubic", "quartic", "chien", "forney" };
+		return names[stage];
+	}
+};
+
+#ifdef DECODER_STATS
+
+#include <atomic>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+class DecoderCounters
+{
+	std::atomic<uint64_t> calls[DecoderStats::STAGES], ticks[DecoderStats::STAGES], outcomes[DecoderStats::OUTCOMES];
+	DecoderCounters()
+	{
+		reset();
+	}
+public:
+	static DecoderCounters &instance()
+	{
+		static DecoderCounters counters;
+		return counters;
+	}
+	static uint64_t clock()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+	void stage(int stage, uint64_t elapsed)
+	{
+		calls[stage].fetch_add(1, std::memory_order_relaxed);
+		ticks[stage].fetch_add(elapsed, std::memory_order_relaxed);
+	}
+	// result of decode: zero for clean blocks, positive for corrected ones and negative for failures
+	void outcome(int result)
+	{
+		outcomes[result < 0 ? DecoderStats::FAILED : result ? DecoderStats::CORRECTED : DecoderStats::CLEAN].fetch_add(1, std::memory_order_relaxed);
+	}
+	void reset()
+	{
+		for (int i = 0; i < DecoderStats::STAGES; ++i)
+			calls[i] = ticks[i] = 0;
+		for (int i = 0; i < DecoderStats::OUTCOMES; ++i)
+			outcomes[i] = 0;
+	}
+	DecoderStats snapshot() const
+	{
+		DecoderStats stats;
+		for (int i = 0; i < DecoderStats::STAGES; ++i) {
+			stats.calls[i] = calls[i].load(std::memory_order_relaxed);
+			stats.ticks[i] = ticks[i].load(std::memory_order_relaxed);
+		}
+		for (int i = 0; i < DecoderStats::OUTCOMES; ++i)
+			stats.outcomes[i] = outcomes[i].load(std::memory_order_relaxed);
+		return stats;
+	}
+};
+
+class DecoderStageTimer
+{
+	int stage;
+	uint64_t start;
+public:
+	explicit DecoderStageTimer(int stage) : stage(stage), start(DecoderCounters::clock())
+	{
+	}
+	~DecoderStageTimer()
+	{
+		DecoderCounters::instance().stage(stage, DecoderCounters::clock() - start);
+	}
+};
+
+#define DECODER_STATS_STAGE(stage) DecoderStageTimer decoder_stage_timer(DecoderStats::stage)
+#define DECODER_STATS_OUTCOME(result) DecoderCounters::instance().outcome(result)
+
+#else
+
+#define DECODER_STATS_STAGE(stage) do {} while (0)
+#define DECODER_STATS_OUTCOME(result) do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,90 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef EUCLIDEAN_HH
+#define EUCLIDEAN_HH
+
+#include <algorithm>
+#include <utility>
+#include "galois_field.hh"
+
+template <int NR, typename GF>
+struct Euclidean
+{
+	typedef typename GF::value_type value_type;
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	static const int N = GF::N, K = N - NR;
+	static const bool EVALUATOR = true;
+	static int degree(ValueType *a, int n)
+	{
+		while (n >= 0 && !a[n])
+			--n;
+		return n;
+	}
+	static int algorithm(ValueType *s, ValueType *C, int count, ValueType *evaluator)
+	{
+		// Sugiyama: the extended euclidean algorithm on $x^{NR}$ and $T = (syndromes * C) \bmod{x^{NR}}$
+		// stops at the first remainder of degree below $(NR+count)/2$, which is the evaluator
+		ValueType R0[NR+1], R1[NR+1], A0[NR+1], A1[NR+1];
+		for (int i = 0; i < NR; ++i) {
+			R0[i] = ValueType(0);
+			R1[i] = s[i] * C[0];
+			for (int j = 1; j <= std::min(i, count); ++j)
+				R1[i] += s[i-j] * C[j];
+			A0[i] = A1[i] = ValueType(0);
+		}
+		R0[NR] = ValueType(1);
+		R1[NR] = A0[NR] = A1[NR] = ValueType(0);
+		A1[0] = ValueType(1);
+		ValueType *r0 = R0, *r1 = R1, *a0 = A0, *a1 = A1;
+		int r0_degree = NR, r1_degree = degree(r1, NR-1);
+		int a0_degree = -1, a1_degree = 0;
+		while (2 * r1_degree >= NR + count) {
+			// $r_0 = r_0 \bmod{r_1}$ and $a_0 = a_0 - (r_0 \div r_1) * a_1$
+			IndexType lead(index(r1[r1_degree]));
+			while (r0_degree >= r1_degree) {
+				int shift = r0_degree - r1_degree;
+				IndexType q(index(r0[r0_degree]) / lead);
+				for (int i = 0; i <= r1_degree; ++i)
+					r0[i+shift] = fma(q, r1[i], r0[i+shift]);
+				for (int i = 0; i <= a1_degree && i + shift <= NR; ++i)
+					a0[i+shift] = fma(q, a1[i], a0[i+shift]);
+				a0_degree = std::max(a0_degree, std::min(NR, a1_degree + shift));
+				r0_degree = degree(r0, r0_degree - 1);
+				if (r0_degree < 0)
+					break;
+			}
+			std::swap(r0, r1);
+			std::swap(a0, a1);
+			std::swap(r0_degree, r1_degree);
+			std::swap(a0_degree, a1_degree);
+		}
+		a1_degree = degree(a1, a1_degree);
+		if (a1_degree < 0 || a1_degree + count > NR || !a1[0])
+			return -1;
+		// $C = a_1 * C$ and both scaled to get $C_0 = 1$
+		IndexType scale(index(a1[0]));
+		ValueType locator[NR+1];
+		for (int i = 0; i <= NR; ++i)
+			locator[i] = ValueType(0);
+		for (int i = 0; i <= a1_degree; ++i) {
+			if (!a1[i])
+				continue;
+			IndexType tmp(index(a1[i]) / scale);
+			for (int j = 0; j <= count; ++j)
+				locator[i+j] = fma(tmp, C[j], locator[i+j]);
+		}
+		for (int i = 0; i <= NR; ++i)
+			C[i] = locator[i];
+		for (int i = 0; i < NR; ++i)
+			evaluator[i] = i <= r1_degree ? r1[i] / scale : ValueType(0);
+		return degree(C, a1_degree + count);
+	}
+};
+
+#endif
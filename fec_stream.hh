@@ -0,0 +1,119 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef FEC_STREAM_HH
+#define FEC_STREAM_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/*
+Byte stream front-end for codecs with byte sized symbols.
+A frame holds DEPTH interleaved codewords, symbol i of codeword d is at frame[i*DEPTH+d].
+This keeps the payload contiguous in frame[0..PAYLOAD) and the parity in frame[PAYLOAD..FRAME),
+so bursts of up to DEPTH*T bytes are spread over DEPTH codewords with at most T errors each.
+Frames are encoded and decoded in place, right in the buffers of the caller.
+*/
+template <typename CODEC, int DEPTH = 1>
+class FecStream
+{
+public:
+	typedef typename CODEC::value_type value_type;
+	static_assert(std::is_same<value_type, uint8_t>::value && CODEC::N <= 255, "need byte sized symbols");
+	static_assert(DEPTH > 0, "DEPTH must be positive");
+	static const int N = CODEC::N, K = CODEC::K, NR = N - K;
+	static const int FRAME = N * DEPTH, PAYLOAD = K * DEPTH;
+	CODEC &codec;
+	explicit FecStream(CODEC &codec) : codec(codec)
+	{
+	}
+	// payload bytes of the partial frame written so far
+	int pending() const
+	{
+		return fill;
+	}
+	// computes the parity of a frame, whose payload is already in frame[0..PAYLOAD)
+	void encode(uint8_t *frame)
+	{
+		// codeword d is the column of stride DEPTH starting at frame[d]
+		for (int d = 0; d < DEPTH; ++d)
+			codec.encode(frame + d, DEPTH);
+	}
+	// same as above with the payload elsewhere, which may also be the frame itself
+	void encode(const uint8_t *payload, uint8_t *frame)
+	{
+		if (payload != frame)
+			std::memmove(frame, payload, PAYLOAD);
+		encode(frame);
+	}
+	/*
+	Appends count bytes to the stream and returns the number of frames completed.
+	frames points to the current frame, which may already hold pending() bytes from earlier calls,
+	so the caller advances it by FRAME bytes for every frame returned.
+	*/
+	int write(const uint8_t *bytes, int count, uint8_t *frames)
+	{
+		int done = 0;
+		while (count > 0) {
+			int copy = std::min(count, PAYLOAD - fill);
+			std::memcpy(frames + fill, bytes, copy);
+			bytes += copy;
+			count -= copy;
+			fill += copy;
+			if (fill == PAYLOAD) {
+				encode(frames);
+				frames += FRAME;
+				fill = 0;
+				++done;
+			}
+		}
+		return done;
+	}
+	// pads the partial frame with zeros, encodes it and returns the number of frames completed
+	int flush(uint8_t *frame)
+	{
+		if (!fill)
+			return 0;
+		std::memset(frame + fill, 0, PAYLOAD - fill);
+		encode(frame);
+		fill = 0;
+		return 1;
+	}
+	/*
+	Corrects count consecutive frames in place.
+	If given, results[f*DEPTH+d] receives the result of codeword d in frame f.
+	Returns the number of corrected symbols or -1 if any codeword was not correctable.
+	*/
+	int decode(uint8_t *frames, int count, int *results = 0)
+	{
+		int corrections = 0;
+		bool failed = false;
+		for (int f = 0; f < count; ++f) {
+			uint8_t *frame = frames + f * FRAME;
+			int *frame_results = results ? results + f * DEPTH : 0;
+			int result;
+			if (DEPTH == 1) {
+				result = codec.decode_fast(frame);
+				if (frame_results)
+					frame_results[0] = result;
+			} else {
+				result = codec.decode_interleaved(frame, DEPTH, frame_results);
+			}
+			if (result < 0)
+				failed = true;
+			else
+				corrections += result;
+		}
+		return failed ? -1 : corrections;
+	}
+private:
+	int fill = 0;
+};
+
+#endif
@@ -8,8 +8,11 @@ You should have received a copy of the CC0 Public Domain Dedication along with t
 #ifndef FIND_LOCATIONS_HH
 #define FIND_LOCATIONS_HH
 
+#include <cstdint>
+#include <utility>
 #include "galois_field.hh"
 #include "chien.hh"
+#include "decoder_stats.hh"
 
 template <int NR, typename GF>
 struct FindLocations
@@ -17,13 +20,133 @@ struct FindLocations
 	typedef typename GF::value_type value_type;
 	typedef typename GF::ValueType ValueType;
 	typedef typename GF::IndexType IndexType;
-	static int search(ValueType *locator, int locator_degree, IndexType *locations)
+	static const int M = GF::M, N = GF::N;
+	static ValueType evaluate(ValueType *locator, int locator_degree, ValueType root)
+	{
+		ValueType sum(locator[locator_degree]);
+		for (int i = locator_degree - 1; i >= 0; --i)
+			sum = sum * root + locator[i];
+		return sum;
+	}
+	static int accept(ValueType *locator, int locator_degree, ValueType *roots, IndexType *locations, int first)
+	{
+		// the closed forms only see the field through tables, so double check the roots
+		for (int i = 0; i < locator_degree; ++i) {
+			if (!roots[i] || evaluate(locator, locator_degree, roots[i]))
+				return 0;
+			for (int j = 0; j < i; ++j)
+				if (roots[i] == roots[j])
+					return 0;
+			locations[i] = index(roots[i]) / IndexType(1);
+			if ((int)locations[i] < first)
+				return 0;
+		}
+		return locator_degree;
+	}
+	static int cubic(ValueType *locator, ValueType *roots)
+	{
+		// $x^3 + bx^2 + cx + d$ with $x = y + b$ turns into $y^3 + py + q$
+		ValueType b(locator[2] / locator[3]), c(locator[1] / locator[3]), d(locator[0] / locator[3]);
+		ValueType p(b * b + c), q(b * c + d);
+		if (!p || !q)
+			return -1;
+		// with $y = z + p/z$ we get $z^6 + qz^3 + p^3 = 0$, so $z^3 = qR$ where $R^2 + R = p^3/q^2$
+		ValueType R(Artin_Schreier_imap(p * p * p / (q * q)));
+		if (!R)
+			return 0;
+		int u = index(q * R).i;
+		if (u % 3)
+			return 0;
+		IndexType z(u / 3), omega(N / 3);
+		for (int i = 0; i < 3; ++i, z *= omega)
+			roots[i] = value(z) + p / z + b;
+		return 3;
+	}
+	static int affine(ValueType s, ValueType t, ValueType c, ValueType *roots)
+	{
+		// $L(z) = z^4 + sz^2 + tz$ is linear over GF(2), so solve $L(z) = c$ by elimination
+		uint64_t rows[M];
+		for (int r = 0; r < M; ++r)
+			rows[r] = (uint64_t)(((int)c >> r) & 1) << M;
+		for (int k = 0; k < M; ++k) {
+			ValueType z(1 << k), zz(z * z), L(zz * zz + s * zz + t * z);
+			for (int r = 0; r < M; ++r)
+				rows[r] |= (uint64_t)(((int)L >> r) & 1) << k;
+		}
+		int pivots[M], rank = 0;
+		for (int k = 0; k < M; ++k) {
+			int r = rank;
+			while (r < M && !((rows[r] >> k) & 1))
+				++r;
+			if (r == M)
+				continue;
+			std::swap(rows[r], rows[rank]);
+			for (int i = 0; i < M; ++i)
+				if (i != rank && (rows[i] >> k) & 1)
+					rows[i] ^= rows[rank];
+			pivots[rank++] = k;
+		}
+		for (int r = rank; r < M; ++r)
+			if ((rows[r] >> M) & 1)
+				return 0;
+		// four distinct roots need a kernel of dimension two
+		if (M - rank != 2)
+			return -1;
+		int particular = 0, kernel[2], nullity = 0;
+		for (int r = 0; r < rank; ++r)
+			particular |= ((rows[r] >> M) & 1) << pivots[r];
+		for (int k = 0, r = 0; k < M; ++k) {
+			if (r < rank && pivots[r] == k) {
+				++r;
+				continue;
+			}
+			int vector = 1 << k;
+			for (int i = 0; i < rank; ++i)
+				vector |= ((rows[i] >> k) & 1) << pivots[i];
+			kernel[nullity++] = vector;
+		}
+		for (int i = 0; i < 4; ++i)
+			roots[i] = ValueType(particular ^ (i & 1 ? kernel[0] : 0) ^ (i & 2 ? kernel[1] : 0));
+		return 4;
+	}
+	static int quartic(ValueType *locator, ValueType *roots)
+	{
+		// $x^4 + ax^3 + bx^2 + cx + d$ with $x = y + \sqrt{c/a}$ loses its linear term
+		ValueType a(locator[3] / locator[4]), b(locator[2] / locator[4]), c(locator[1] / locator[4]), d(locator[0] / locator[4]);
+		if (!a) {
+			if (!d)
+				return -1;
+			return affine(b, c, d, roots);
+		}
+		ValueType shift(0);
+		if (c) {
+			int k = index(c / a).i;
+			shift = value(IndexType(k & 1 ? (k + N) / 2 : k / 2));
+		}
+		ValueType e(a * shift + b);
+		ValueType f(((shift + a) * shift + b) * shift * shift + c * shift + d);
+		if (!f)
+			return -1;
+		// with $y = 1/z$ we get $z^4 + \frac{e}{f}z^2 + \frac{a}{f}z = \frac{1}{f}$
+		int count = affine(e / f, a / f, rcp(f), roots);
+		if (count <= 0)
+			return count;
+		for (int i = 0; i < 4; ++i) {
+			if (!roots[i])
+				return 0;
+			roots[i] = rcp(roots[i]) + shift;
+		}
+		return 4;
+	}
+	static int search(ValueType *locator, int locator_degree, IndexType *locations, int first = 0)
 	{
 		if (locator_degree == 1) {
+			DECODER_STATS_STAGE(DEGREE1);
 			locations[0] = (index(locator[0]) / index(locator[1])) / IndexType(1);
-			return 1;
+			return (int)locations[0] >= first;
 		}
 		if (locator_degree == 2) {
+			DECODER_STATS_STAGE(DEGREE2);
 			if (!locator[1] || !locator[0])
 				return 0;
 			ValueType a(locator[2]), b(locator[1]), c(locator[0]);
@@ -32,9 +155,26 @@ struct FindLocations
 				return 0;
 			locations[0] = index(ba * R) / IndexType(1);
 			locations[1] = index(ba * R + ba) / IndexType(1);
+			if ((int)locations[0] < first || (int)locations[1] < first)
+				return 0;
 			return 2;
 		}
-		return Chien<NR, GF>::search(locator, locator_degree, locations);
+		if (locator_degree == 3 && N % 3 == 0 && locator[0]) {
+			DECODER_STATS_STAGE(CUBIC);
+			ValueType roots[3];
+			int count = cubic(locator, roots);
+			if (count >= 0)
+				return count ? accept(locator, 3, roots, locations, first) : 0;
+		}
+		if (locator_degree == 4 && locator[0]) {
+			DECODER_STATS_STAGE(QUARTIC);
+			ValueType roots[4];
+			int count = quartic(locator, roots);
+			if (count >= 0)
+				return count ? accept(locator, 4, roots, locations, first) : 0;
+		}
+		DECODER_STATS_STAGE(CHIEN);
+		return Chien<NR, GF>::search(locator, locator_degree, locations, first);
 	}
 };
 
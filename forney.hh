@@ -34,30 +34,47 @@ struct Forney
 	static void compute_magnitudes(ValueType *locator, IndexType *locations, int count, ValueType *evaluator, int evaluator_degree, ValueType *magnitudes)
 	{
 		// $magnitude = root^{FCR-1} * \frac{evaluator(root)}{locator'(root)}$
+		// evaluated for all roots at once, so the inner loops run across locations
+		// sums are kept as int, as stores through byte sized symbols could alias everything
+		int roots[NR], powers[NR], evals[NR], derivs[NR];
 		for (int i = 0; i < count; ++i) {
-			IndexType root(locations[i] * IndexType(1)), tmp(root);
-			ValueType eval(evaluator[0]);
-			for (int j = 1; j <= evaluator_degree; ++j) {
-				eval += evaluator[j] * tmp;
-				tmp *= root;
+			roots[i] = (int)(locations[i] * IndexType(1));
+			powers[i] = roots[i];
+			evals[i] = (int)evaluator[0];
+		}
+		for (int j = 1; j <= evaluator_degree; ++j) {
+			int coefficient = evaluator[j].exponent();
+			for (int i = 0; i < count; ++i) {
+				evals[i] ^= (int)ValueType::power(coefficient + powers[i]);
+				int tmp = powers[i] + roots[i];
+				powers[i] = tmp < N ? tmp : tmp - N;
+			}
+		}
+		// only the odd coefficients survive in the formal derivative, so step by $root^2$
+		for (int i = 0; i < count; ++i) {
+			int tmp = 2 * roots[i];
+			roots[i] = tmp < N ? tmp : tmp - N;
+			powers[i] = roots[i];
+			derivs[i] = (int)locator[1];
+		}
+		for (int j = 3; j <= count; j += 2) {
+			int coefficient = locator[j].exponent();
+			for (int i = 0; i < count; ++i) {
+				derivs[i] ^= (int)ValueType::power(coefficient + powers[i]);
+				int tmp = powers[i] + roots[i];
+				powers[i] = tmp < N ? tmp : tmp - N;
 			}
-			if (!eval) {
+		}
+		// $root^{FCR-1}$ in one step
+		const int SHIFT = ((FCR - 1) % N + N) % N;
+		for (int i = 0; i < count; ++i) {
+			if (!evals[i]) {
 				magnitudes[i] = ValueType(0);
 				continue;
 			}
-			ValueType deriv(locator[1]);
-			IndexType root2(root * root), tmp2(root2);
-			for (int j = 3; j <= count; j += 2) {
-				deriv += locator[j] * tmp2;
-				tmp2 *= root2;
-			}
-			IndexType magnitude(index(eval) / index(deriv));
-			if (FCR == 0)
-				magnitude /= root;
-			if (FCR > 1)
-				for (int j = 1; j < FCR; ++j)
-					magnitude *= root;
-			magnitudes[i] = value(magnitude);
+			IndexType root(locations[i] * IndexType(1));
+			IndexType shift((long long)SHIFT * (int)root % N);
+			magnitudes[i] = value(index(ValueType(evals[i])) / index(ValueType(derivs[i])) * shift);
 		}
 	}
 	static int algorithm(ValueType *syndromes, ValueType *locator, IndexType *locations, int count, ValueType *evaluator, ValueType *magnitudes)
@@ -8,14 +8,142 @@ You should have received a copy of the CC0 Public Domain Dedication along with t
 #ifndef GALOIS_FIELD_HH
 #define GALOIS_FIELD_HH
 
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#if defined(__PCLMUL__) && defined(__x86_64__)
+#include <immintrin.h>
+#define CARRYLESS_MULTIPLY
+#endif
+
 namespace GF {
 
-#include "galois_field_tables.hh"
+template <int M, int POLY, typename TYPE>
+struct Tables
+{
+	static const int Q = 1 << M, N = Q - 1;
+	static_assert(M <= 8 * sizeof(TYPE), "TYPE not wide enough");
+	static_assert(Q == (POLY & ~N), "POLY not of degree Q");
+	// log(0) is a sentinel that makes sums with it index the zeros in the upper half of exp,
+	// logarithms stay in TYPE when it can hold the sentinel and widen only when it can not
+	static const int ZERO = 2 * N;
+	typedef typename std::conditional<ZERO <= std::numeric_limits<TYPE>::max(), TYPE,
+		typename std::conditional<M < 16, uint16_t, uint32_t>::type>::type LogType;
+	struct Arrays
+	{
+		alignas(64) LogType log[Q];
+		alignas(64) TYPE exp[2*ZERO+1];
+		alignas(64) TYPE Artin_Schreier_imap[Q];
+		bool primitive;
+	};
+	static constexpr Arrays generate()
+	{
+		Arrays t {};
+		t.log[0] = ZERO;
+		int a = 1;
+		for (int i = 0; i < N; ++i, a = a & (Q >> 1) ? (a << 1) ^ POLY : a << 1) {
+			t.primitive = !i || a != 1;
+			if (!t.primitive)
+				return t;
+			t.log[a] = i;
+			t.exp[i] = t.exp[N+i] = a;
+		}
+		t.primitive = a == 1;
+		// $x^2 + x = xxx$ has the solutions x and x+1, store the even one
+		for (int x = 2; x < N; x += 2)
+			t.Artin_Schreier_imap[t.exp[2*t.log[x]] ^ x] = x;
+		return t;
+	}
+	static constexpr Arrays arrays = generate();
+	static_assert(arrays.primitive, "POLY not primitive");
+	static int log(TYPE a)
+	{
+		return arrays.log[a];
+	}
+	static TYPE exp(int a)
+	{
+		return arrays.exp[a];
+	}
+	static TYPE Artin_Schreier_imap(TYPE a)
+	{
+		return arrays.Artin_Schreier_imap[a];
+	}
+};
 
 template <int M, int POLY, typename TYPE>
-struct Index;
+constexpr typename Tables<M, POLY, TYPE>::Arrays Tables<M, POLY, TYPE>::arrays;
 
+// products through the log and exp tables
 template <int M, int POLY, typename TYPE>
+struct TableArithmetic
+{
+	static TYPE mul(TYPE a, TYPE b)
+	{
+		return Tables<M, POLY, TYPE>::exp(Tables<M, POLY, TYPE>::log(a) + Tables<M, POLY, TYPE>::log(b));
+	}
+	// $pe^i * b$
+	static TYPE scale(int i, TYPE b)
+	{
+		return Tables<M, POLY, TYPE>::exp(i + Tables<M, POLY, TYPE>::log(b));
+	}
+};
+
+/*
+Products through carry-less multiplication and Barrett reduction by POLY, no tables involved.
+Uses PCLMULQDQ when available and a shift and xor loop otherwise.
+The log domain and divisions still go through the tables, but with far fewer random accesses to the tables.
+*/
+template <int M, int POLY, typename TYPE>
+struct CarrylessArithmetic
+{
+	static_assert(M <= 32, "M too large for 64 bit products");
+	static const int N = (1 << M) - 1;
+	// $mu = \lfloor x^{2M} / POLY \rfloor$
+	static constexpr uint64_t barrett()
+	{
+		uint64_t r = 1ULL << 2 * M, q = 0;
+		for (int i = M; i >= 0; --i) {
+			if ((r >> (M + i)) & 1) {
+				q |= 1ULL << i;
+				r ^= (uint64_t)POLY << i;
+			}
+		}
+		return q;
+	}
+	static const uint64_t MU = barrett();
+	// b has at most M+1 bits
+	static uint64_t clmul(uint64_t a, uint64_t b)
+	{
+#ifdef CARRYLESS_MULTIPLY
+		return _mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_cvtsi64_si128(a), _mm_cvtsi64_si128(b), 0));
+#else
+		uint64_t r = 0;
+		for (int i = 0; i <= M; ++i)
+			r ^= (a << i) & -((b >> i) & 1);
+		return r;
+#endif
+	}
+	static TYPE reduce(uint64_t p)
+	{
+		// $q = \lfloor \lfloor p / x^M \rfloor * mu / x^M \rfloor$ is exact for polynomials, leaving $p - q * POLY$
+		uint64_t q = clmul(p >> M, MU) >> M;
+		return (p ^ clmul(q, POLY)) & N;
+	}
+	static TYPE mul(TYPE a, TYPE b)
+	{
+		return reduce(clmul(a, b));
+	}
+	static TYPE scale(int i, TYPE b)
+	{
+		return mul(Tables<M, POLY, TYPE>::exp(i), b);
+	}
+};
+
+template <int M, int POLY, typename TYPE, typename ARITH>
+struct Index;
+
+template <int M, int POLY, typename TYPE, typename ARITH>
 struct Value
 {
 	static const int Q = 1 << M, N = Q - 1;
@@ -29,28 +157,38 @@ struct Value
 	}
 	explicit operator bool () const { return v; }
 	explicit operator int () const { return v; }
-	Value<M, POLY, TYPE> operator *= (Index<M, POLY, TYPE> a)
+	Value<M, POLY, TYPE, ARITH> operator *= (Index<M, POLY, TYPE, ARITH> a)
 	{
 		assert(a.i < a.modulus());
 		return *this = *this * a;
 	}
-	Value<M, POLY, TYPE> operator *= (Value<M, POLY, TYPE> a)
+	Value<M, POLY, TYPE, ARITH> operator *= (Value<M, POLY, TYPE, ARITH> a)
 	{
 		assert(a.v <= a.N);
 		return *this = *this * a;
 	}
-	Value<M, POLY, TYPE> operator += (Value<M, POLY, TYPE> a)
+	Value<M, POLY, TYPE, ARITH> operator += (Value<M, POLY, TYPE, ARITH> a)
 	{
 		assert(a.v <= a.N);
 		return *this = *this + a;
 	}
-	static const Value<M, POLY, TYPE> zero()
+	static const Value<M, POLY, TYPE, ARITH> zero()
 	{
-		return Value<M, POLY, TYPE>(0);
+		return Value<M, POLY, TYPE, ARITH>(0);
+	}
+	// logarithm of v, or a sentinel for zero that power() maps back to zero
+	int exponent() const
+	{
+		return Tables<M, POLY, TYPE>::log(v);
+	}
+	static const Value<M, POLY, TYPE, ARITH> power(int e)
+	{
+		assert(0 <= e && e <= 4 * N);
+		return Value<M, POLY, TYPE, ARITH>(Tables<M, POLY, TYPE>::exp(e));
 	}
 };
 
-template <int M, int POLY, typename TYPE>
+template <int M, int POLY, typename TYPE, typename ARITH>
 struct Index
 {
 	static const int Q = 1 << M, N = Q - 1;
@@ -63,13 +201,13 @@ struct Index
 		assert(i < modulus());
 	}
 	explicit operator int () const { return i; }
-	Index<M, POLY, TYPE> operator *= (Index<M, POLY, TYPE> a)
+	Index<M, POLY, TYPE, ARITH> operator *= (Index<M, POLY, TYPE, ARITH> a)
 	{
 		assert(a.i < a.modulus());
 		assert(i < modulus());
 		return *this = *this * a;
 	}
-	Index<M, POLY, TYPE> operator /= (Index<M, POLY, TYPE> a)
+	Index<M, POLY, TYPE, ARITH> operator /= (Index<M, POLY, TYPE, ARITH> a)
 	{
 		assert(a.i < a.modulus());
 		assert(i < modulus());
@@ -81,177 +219,190 @@ struct Index
 	}
 };
 
-template <int WIDTH, int POLY, typename TYPE>
+// ARITHMETIC decides how products are computed, see TableArithmetic and CarrylessArithmetic
+template <int WIDTH, int POLYNOMIAL, typename TYPE, template <int, int, typename> class ARITHMETIC = TableArithmetic>
 struct Types
 {
-	static const int M = WIDTH, Q = 1 << M, N = Q - 1;
+	static const int M = WIDTH, POLY = POLYNOMIAL, Q = 1 << M, N = Q - 1;
 	typedef TYPE value_type;
-	typedef Value<M, POLY, TYPE> ValueType;
-	typedef Index<M, POLY, TYPE> IndexType;
+	typedef ARITHMETIC<M, POLY, TYPE> Arithmetic;
+	typedef Value<M, POLY, TYPE, Arithmetic> ValueType;
+	typedef Index<M, POLY, TYPE, Arithmetic> IndexType;
 };
 
-template <int M, int POLY, typename TYPE>
-Index<M, POLY, TYPE> index(Value<M, POLY, TYPE> a)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Index<M, POLY, TYPE, ARITH> index(Value<M, POLY, TYPE, ARITH> a)
 {
 	assert(a.v <= a.N);
 	assert(a.v);
-	return Index<M, POLY, TYPE>(Tables<M, POLY, TYPE>::log(a.v));
+	return Index<M, POLY, TYPE, ARITH>(Tables<M, POLY, TYPE>::log(a.v));
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> value(Index<M, POLY, TYPE> a) {
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> value(Index<M, POLY, TYPE, ARITH> a) {
 	assert(a.i < a.modulus());
-	return Value<M, POLY, TYPE>(Tables<M, POLY, TYPE>::exp(a.i));
+	return Value<M, POLY, TYPE, ARITH>(Tables<M, POLY, TYPE>::exp(a.i));
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> Artin_Schreier_imap(Value<M, POLY, TYPE> a) {
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> product(Index<M, POLY, TYPE, ARITH> a, Index<M, POLY, TYPE, ARITH> b)
+{
+	// same as value(a * b) but without the reduction modulo N
+	assert(a.i < a.modulus());
+	assert(b.i < b.modulus());
+	return Value<M, POLY, TYPE, ARITH>::power(a.i + b.i);
+}
+
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> Artin_Schreier_imap(Value<M, POLY, TYPE, ARITH> a) {
 	assert(a.v <= a.N);
 	assert(a.v);
-	return Value<M, POLY, TYPE>(Tables<M, POLY, TYPE>::Artin_Schreier_imap(a.v));
+	return Value<M, POLY, TYPE, ARITH>(Tables<M, POLY, TYPE>::Artin_Schreier_imap(a.v));
 }
 
-template <int M, int POLY, typename TYPE>
-bool operator == (Value<M, POLY, TYPE> a, Value<M, POLY, TYPE> b)
+template <int M, int POLY, typename TYPE, typename ARITH>
+bool operator == (Value<M, POLY, TYPE, ARITH> a, Value<M, POLY, TYPE, ARITH> b)
 {
 	assert(a.v <= a.N);
 	assert(b.v <= b.N);
 	return a.v == b.v;
 }
 
-template <int M, int POLY, typename TYPE>
-bool operator != (Value<M, POLY, TYPE> a, Value<M, POLY, TYPE> b)
+template <int M, int POLY, typename TYPE, typename ARITH>
+bool operator != (Value<M, POLY, TYPE, ARITH> a, Value<M, POLY, TYPE, ARITH> b)
 {
 	assert(a.v <= a.N);
 	assert(b.v <= b.N);
 	return a.v != b.v;
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> operator + (Value<M, POLY, TYPE> a, Value<M, POLY, TYPE> b)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> operator + (Value<M, POLY, TYPE, ARITH> a, Value<M, POLY, TYPE, ARITH> b)
 {
 	assert(a.v <= a.N);
 	assert(b.v <= b.N);
-	return Value<M, POLY, TYPE>(a.v ^ b.v);
+	return Value<M, POLY, TYPE, ARITH>(a.v ^ b.v);
 }
 
-template <int M, int POLY, typename TYPE>
-Index<M, POLY, TYPE> operator * (Index<M, POLY, TYPE> a, Index<M, POLY, TYPE> b)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Index<M, POLY, TYPE, ARITH> operator * (Index<M, POLY, TYPE, ARITH> a, Index<M, POLY, TYPE, ARITH> b)
 {
 	assert(a.i < a.modulus());
 	assert(b.i < b.modulus());
-	TYPE tmp = a.i + b.i;
-	return Index<M, POLY, TYPE>(a.modulus() - a.i <= b.i ? tmp - a.modulus() : tmp);
+	// tmp - N wraps around above tmp unless the sum reaches N, so min reduces without a branch
+	unsigned tmp = a.i + b.i;
+	return Index<M, POLY, TYPE, ARITH>(std::min(tmp, tmp - a.N));
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> operator * (Value<M, POLY, TYPE> a, Value<M, POLY, TYPE> b)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> operator * (Value<M, POLY, TYPE, ARITH> a, Value<M, POLY, TYPE, ARITH> b)
 {
 	assert(a.v <= a.N);
 	assert(b.v <= b.N);
-	return (!a.v || !b.v) ? a.zero() : value(index(a) * index(b));
+	return Value<M, POLY, TYPE, ARITH>(ARITH::mul(a.v, b.v));
 }
 
-template <int M, int POLY, typename TYPE>
-Index<M, POLY, TYPE> rcp(Index<M, POLY, TYPE> a)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Index<M, POLY, TYPE, ARITH> rcp(Index<M, POLY, TYPE, ARITH> a)
 {
 	assert(a.i < a.modulus());
-	return Index<M, POLY, TYPE>(!a.i ? 0 : a.modulus() - a.i);
+	return Index<M, POLY, TYPE, ARITH>(!a.i ? 0 : a.modulus() - a.i);
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> rcp(Value<M, POLY, TYPE> a)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> rcp(Value<M, POLY, TYPE, ARITH> a)
 {
 	assert(a.v <= a.N);
 	assert(a.v);
 	return value(rcp(index(a)));
 }
 
-template <int M, int POLY, typename TYPE>
-Index<M, POLY, TYPE> operator / (Index<M, POLY, TYPE> a, Index<M, POLY, TYPE> b)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Index<M, POLY, TYPE, ARITH> operator / (Index<M, POLY, TYPE, ARITH> a, Index<M, POLY, TYPE, ARITH> b)
 {
 	assert(a.i < a.modulus());
 	assert(b.i < b.modulus());
-	TYPE tmp = a.i - b.i;
-	return Index<M, POLY, TYPE>(a.i < b.i ? tmp + a.modulus() : tmp);
+	// the same for a difference that wraps around below zero
+	unsigned tmp = a.i - b.i;
+	return Index<M, POLY, TYPE, ARITH>(std::min(tmp, tmp + a.N));
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> operator / (Value<M, POLY, TYPE> a, Value<M, POLY, TYPE> b)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> operator / (Value<M, POLY, TYPE, ARITH> a, Value<M, POLY, TYPE, ARITH> b)
 {
 	assert(a.v <= a.N);
 	assert(b.v <= b.N);
 	assert(b.v);
-	return !a.v ? a.zero() : value(index(a) / index(b));
+	return a.power(a.exponent() + a.N - b.exponent());
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> operator / (Index<M, POLY, TYPE> a, Value<M, POLY, TYPE> b)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> operator / (Index<M, POLY, TYPE, ARITH> a, Value<M, POLY, TYPE, ARITH> b)
 {
 	assert(a.i < a.modulus());
 	assert(b.v <= b.N);
 	assert(b.v);
-	return value(a / index(b));
+	return b.power(a.i + b.N - b.exponent());
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> operator / (Value<M, POLY, TYPE> a, Index<M, POLY, TYPE> b)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> operator / (Value<M, POLY, TYPE, ARITH> a, Index<M, POLY, TYPE, ARITH> b)
 {
 	assert(a.v <= a.N);
 	assert(b.i < b.modulus());
-	return !a.v ? a.zero() : value(index(a) / b);
+	return a.power(a.exponent() + a.N - b.i);
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> operator * (Index<M, POLY, TYPE> a, Value<M, POLY, TYPE> b)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> operator * (Index<M, POLY, TYPE, ARITH> a, Value<M, POLY, TYPE, ARITH> b)
 {
 	assert(a.i < a.modulus());
 	assert(b.v <= b.N);
-	return !b.v ? b.zero() : value(a * index(b));
+	return Value<M, POLY, TYPE, ARITH>(ARITH::scale(a.i, b.v));
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> operator * (Value<M, POLY, TYPE> a, Index<M, POLY, TYPE> b)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> operator * (Value<M, POLY, TYPE, ARITH> a, Index<M, POLY, TYPE, ARITH> b)
 {
 	assert(a.v <= a.N);
 	assert(b.i < b.modulus());
-	return !a.v ? a.zero() : value(index(a) * b);
+	return Value<M, POLY, TYPE, ARITH>(ARITH::scale(b.i, a.v));
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> fma(Index<M, POLY, TYPE> a, Index<M, POLY, TYPE> b, Value<M, POLY, TYPE> c)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> fma(Index<M, POLY, TYPE, ARITH> a, Index<M, POLY, TYPE, ARITH> b, Value<M, POLY, TYPE, ARITH> c)
 {
 	assert(a.i < a.modulus());
 	assert(b.i < b.modulus());
 	assert(c.v <= c.N);
-	return value(a * b) + c;
+	return product(a, b) + c;
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> fma(Index<M, POLY, TYPE> a, Value<M, POLY, TYPE> b, Value<M, POLY, TYPE> c)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> fma(Index<M, POLY, TYPE, ARITH> a, Value<M, POLY, TYPE, ARITH> b, Value<M, POLY, TYPE, ARITH> c)
 {
 	assert(a.i < a.modulus());
 	assert(b.v <= b.N);
 	assert(c.v <= c.N);
-	return !b.v ? c : (value(a * index(b)) + c);
+	return Value<M, POLY, TYPE, ARITH>(ARITH::scale(a.i, b.v)) + c;
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> fma(Value<M, POLY, TYPE> a, Index<M, POLY, TYPE> b, Value<M, POLY, TYPE> c)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> fma(Value<M, POLY, TYPE, ARITH> a, Index<M, POLY, TYPE, ARITH> b, Value<M, POLY, TYPE, ARITH> c)
 {
 	assert(a.v <= a.N);
 	assert(b.i < b.modulus());
 	assert(c.v <= c.N);
-	return !a.v ? c : (value(index(a) * b) + c);
+	return Value<M, POLY, TYPE, ARITH>(ARITH::scale(b.i, a.v)) + c;
 }
 
-template <int M, int POLY, typename TYPE>
-Value<M, POLY, TYPE> fma(Value<M, POLY, TYPE> a, Value<M, POLY, TYPE> b, Value<M, POLY, TYPE> c)
+template <int M, int POLY, typename TYPE, typename ARITH>
+Value<M, POLY, TYPE, ARITH> fma(Value<M, POLY, TYPE, ARITH> a, Value<M, POLY, TYPE, ARITH> b, Value<M, POLY, TYPE, ARITH> c)
 {
 	assert(a.v <= a.N);
 	assert(b.v <= b.N);
 	assert(c.v <= c.N);
-	return (!a.v || !b.v) ? c : (value(index(a) * index(b)) + c);
+	return Value<M, POLY, TYPE, ARITH>(ARITH::mul(a.v, b.v)) + c;
 }
 
 }
@@ -0,0 +1,236 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef GFNI_HH
+#define GFNI_HH
+
+#include <cstdint>
+#include <algorithm>
+#include "galois_field.hh"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GFNI_KERNELS
+#endif
+
+/*
+Bytes of GF(2^8) for any field polynomial with the Galois Field New Instructions.
+GF2P8AFFINEQB applies any 8x8 bit matrix to every byte, which multiplies by a constant of our field directly.
+GF2P8MULB multiplies two variables, but only in the AES field $x^8+x^4+x^3+x+1$,
+so those products take a detour through the field isomorphism, which is a bit matrix as well.
+The scalar versions of both instructions below keep everything testable without GFNI.
+*/
+struct GaloisFieldNewInstructions
+{
+	static const int AES = 0b100011011;
+	// bit j of row i says if input bit j adds to output bit i, row i lives in byte 7-i like GF2P8AFFINEQB expects
+	static uint64_t matrix(const uint8_t *rows)
+	{
+		uint64_t tmp = 0;
+		for (int i = 0; i < 8; ++i)
+			tmp |= (uint64_t)rows[i] << (8 * (7 - i));
+		return tmp;
+	}
+	// the matrix of the linear map with $f(2^j) = columns_j$
+	static uint64_t columns(const uint8_t *columns)
+	{
+		uint8_t rows[8] = { 0 };
+		for (int j = 0; j < 8; ++j)
+			for (int i = 0; i < 8; ++i)
+				rows[i] |= ((columns[j] >> i) & 1) << j;
+		return matrix(rows);
+	}
+	// the matrix of $x \mapsto c\,x$ in GF(2^M) for $M \le 8$, the unused bits stay zero
+	template <int M, typename ValueType>
+	static uint64_t multiply(ValueType c)
+	{
+		uint8_t tmp[8];
+		for (int j = 0; j < 8; ++j)
+			tmp[j] = j < M ? (int)(c * ValueType(1 << j)) : 0;
+		return columns(tmp);
+	}
+	static uint8_t affine(uint64_t matrix, uint8_t x)
+	{
+		uint8_t y = 0;
+		for (int i = 0; i < 8; ++i)
+			y |= __builtin_parity((matrix >> (8 * (7 - i))) & 255 & x) << i;
+		return y;
+	}
+	static uint8_t aes_mul(uint8_t a, uint8_t b)
+	{
+		int p = 0;
+		for (int i = 0; i < 8; ++i)
+			if ((b >> i) & 1)
+				p ^= a << i;
+		for (int i = 15; i >= 8; --i)
+			if ((p >> i) & 1)
+				p ^= AES << (i - 8);
+		return p;
+	}
+#ifdef GFNI_KERNELS
+	static bool supported()
+	{
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("gfni") && __builtin_cpu_supports("avx512bw");
+	}
+	// $syndromes_i = code(root_i)$, matrices hold $root_i^{2^t}$ for $t = 0 \dots 6$ like ShuffleSyndromes
+	__attribute__((target("gfni,avx512bw")))
+	static void syndromes(const uint8_t *code, int length, const uint64_t *matrices, int roots, uint8_t *syndromes)
+	{
+		const int W = 64, POWERS = 7;
+		int head = length % W;
+		uint8_t first[W] = { 0 };
+		for (int i = 0; i < head; ++i)
+			first[W-head+i] = code[i];
+		for (int i = 0; i < roots; ++i, matrices += POWERS) {
+			__m512i step = _mm512_set1_epi64(matrices[6]);
+			__m512i acc = _mm512_loadu_si512((const void *)first);
+			for (int j = head; j < length; j += W)
+				acc = _mm512_xor_si512(_mm512_gf2p8affine_epi64_epi8(acc, step, 0), _mm512_loadu_si512((const void *)(code + j)));
+			// lane k holds the sum for $root^{W-1-k}$, so fold the upper halves onto the lower ones
+			__m256i acc256 = _mm256_xor_si256(_mm256_gf2p8affine_epi64_epi8(_mm512_maskz_extracti64x4_epi64(-1, acc, 0), _mm256_set1_epi64x(matrices[5]), 0), _mm512_maskz_extracti64x4_epi64(-1, acc, 1));
+			__m128i acc128 = _mm_xor_si128(_mm_gf2p8affine_epi64_epi8(_mm256_castsi256_si128(acc256), _mm_set1_epi64x(matrices[4]), 0), _mm256_extracti128_si256(acc256, 1));
+			acc128 = _mm_xor_si128(_mm_gf2p8affine_epi64_epi8(acc128, _mm_set1_epi64x(matrices[3]), 0), _mm_srli_si128(acc128, 8));
+			acc128 = _mm_xor_si128(_mm_gf2p8affine_epi64_epi8(acc128, _mm_set1_epi64x(matrices[2]), 0), _mm_srli_si128(acc128, 4));
+			acc128 = _mm_xor_si128(_mm_gf2p8affine_epi64_epi8(acc128, _mm_set1_epi64x(matrices[1]), 0), _mm_srli_si128(acc128, 2));
+			acc128 = _mm_xor_si128(_mm_gf2p8affine_epi64_epi8(acc128, _mm_set1_epi64x(matrices[0]), 0), _mm_srli_si128(acc128, 1));
+			syndromes[i] = _mm_cvtsi128_si32(acc128);
+		}
+	}
+	// $parity = (data * x^{NR}) \bmod{generator}$ with the register kept in the AES field, symbols are stride bytes apart,
+	// generator holds the images of $generator_{NR-1-j}$ padded with zeros to 64 bytes
+	__attribute__((target("gfni,avx512bw")))
+	static void encode(const uint8_t *data, int length, int stride, const uint8_t *generator, const uint8_t *to_aes, const uint8_t *from_aes, int roots, uint8_t *parity)
+	{
+		__m128i gen[4], reg[4];
+		for (int w = 0; w < 4; ++w) {
+			gen[w] = _mm_loadu_si128((const __m128i *)(generator + 16 * w));
+			reg[w] = _mm_setzero_si128();
+		}
+		int words = (roots + 15) / 16;
+		// the feedback stays in the vector registers, only the data symbols come from the table
+		__m128i lowest = _mm_setzero_si128();
+		for (int i = 0; i < length; ++i) {
+			__m128i feedback = _mm_xor_si128(_mm_shuffle_epi8(reg[0], lowest), _mm_set1_epi8(to_aes[data[i*stride]]));
+			for (int w = 0; w < 3; ++w)
+				if (w + 1 < words)
+					reg[w] = _mm_xor_si128(_mm_alignr_epi8(reg[w+1], reg[w], 1), _mm_gf2p8mul_epi8(feedback, gen[w]));
+			reg[words-1] = _mm_xor_si128(_mm_srli_si128(reg[words-1], 1), _mm_gf2p8mul_epi8(feedback, gen[words-1]));
+		}
+		uint8_t tmp[64];
+		for (int w = 0; w < 4; ++w)
+			_mm_storeu_si128((__m128i *)(tmp + 16 * w), reg[w]);
+		for (int j = 0; j < roots; ++j)
+			parity[j*stride] = from_aes[tmp[j]];
+	}
+	// syndromes of the columns adjacent codewords of an interleaved frame, symbol j of codeword d is at code[j*stride+d]
+	// and its syndromes end up at syndromes + d*roots, each lane of a vector follows one codeword through Horner
+	__attribute__((target("gfni,avx512bw")))
+	static void interleaved(const uint8_t *code, int length, int stride, int columns, const uint64_t *matrices, int roots, uint8_t *syndromes)
+	{
+		const int W = 64, POWERS = 7, BLOCK = 4;
+		for (int c = 0; c < columns; c += W) {
+			int lanes = std::min(W, columns - c);
+			__mmask64 mask = lanes < W ? ((__mmask64)1 << lanes) - 1 : ~(__mmask64)0;
+			// a few roots at a time, so the products are independent of each other
+			for (int i = 0; i < roots; i += BLOCK) {
+				__m512i acc[BLOCK], step[BLOCK];
+				for (int k = 0; k < BLOCK; ++k) {
+					acc[k] = _mm512_setzero_si512();
+					step[k] = _mm512_set1_epi64(matrices[std::min(i + k, roots - 1) * POWERS]);
+				}
+				for (int j = 0; j < length; ++j) {
+					__m512i symbols = _mm512_maskz_loadu_epi8(mask, (const void *)(code + j * stride + c));
+					for (int k = 0; k < BLOCK; ++k)
+						acc[k] = _mm512_xor_si512(_mm512_gf2p8affine_epi64_epi8(acc[k], step[k], 0), symbols);
+				}
+				uint8_t tmp[W];
+				for (int k = 0; k < BLOCK && i + k < roots; ++k) {
+					_mm512_storeu_si512((void *)tmp, acc[k]);
+					for (int l = 0; l < lanes; ++l)
+						syndromes[(c+l)*roots+i+k] = tmp[l];
+				}
+			}
+		}
+	}
+	// evaluates $constant + \sum_k terms_k$ at 64 positions per step, the term of $x^k$ starts as powers_k times scales_k
+	// and is multiplied by steps_k after each step, bit l of roots_s is set if position $64s+l$ is a root
+	__attribute__((target("gfni,avx512bw")))
+	static void chien(const uint8_t *powers, const uint64_t *scales, const uint64_t *steps, uint8_t *terms, int count, uint8_t constant, int length, uint64_t *roots)
+	{
+		for (int k = 0; k < count; ++k)
+			_mm512_storeu_si512((void *)(terms + 64 * k), _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512((const void *)(powers + 64 * k)), _mm512_set1_epi64(scales[k]), 0));
+		for (int s = 0; 64 * s < length; ++s) {
+			__m512i sum = _mm512_set1_epi8(constant);
+			for (int k = 0; k < count; ++k) {
+				__m512i term = _mm512_loadu_si512((const void *)(terms + 64 * k));
+				sum = _mm512_xor_si512(sum, term);
+				_mm512_storeu_si512((void *)(terms + 64 * k), _mm512_gf2p8affine_epi64_epi8(term, _mm512_set1_epi64(steps[k]), 0));
+			}
+			roots[s] = _mm512_cmpeq_epi8_mask(sum, _mm512_setzero_si512());
+		}
+	}
+#endif
+};
+
+// the tables for GF(2^8) with POLY that the kernels need
+template <typename GF>
+struct GaloisFieldAffine
+{
+	typedef typename GF::value_type value_type;
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	static_assert(GF::M == 8 && sizeof(value_type) == 1, "only for bytes of GF(2^8)");
+	typedef GaloisFieldNewInstructions GFNI;
+	// $to\_aes$ maps x to a root of POLY in the AES field, which extends to an isomorphism of the fields
+	uint8_t to_aes[256], from_aes[256];
+	uint64_t to_aes_matrix, from_aes_matrix;
+	GaloisFieldAffine()
+	{
+		int beta = 2;
+		for (;; ++beta) {
+			// $POLY(beta) = 0$ in the AES field with Horner
+			int tmp = 1;
+			for (int i = GF::M - 1; i >= 0; --i)
+				tmp = GFNI::aes_mul(tmp, beta) ^ ((GF::POLY >> i) & 1);
+			if (!tmp)
+				break;
+		}
+		uint8_t powers[8];
+		powers[0] = 1;
+		for (int j = 1; j < 8; ++j)
+			powers[j] = GFNI::aes_mul(powers[j-1], beta);
+		to_aes_matrix = GFNI::columns(powers);
+		for (int x = 0; x < 256; ++x) {
+			to_aes[x] = GFNI::affine(to_aes_matrix, x);
+			from_aes[to_aes[x]] = x;
+		}
+		uint8_t inverse[8];
+		for (int j = 0; j < 8; ++j)
+			inverse[j] = from_aes[1 << j];
+		from_aes_matrix = GFNI::columns(inverse);
+	}
+	static uint64_t matrix(ValueType c)
+	{
+		return GFNI::multiply<GF::M>(c);
+	}
+	static uint64_t matrix(IndexType c)
+	{
+		return matrix(value(c));
+	}
+	// $a * b$ in our field through GF2P8MULB in the AES field
+	uint8_t mul(uint8_t a, uint8_t b) const
+	{
+		return from_aes[GFNI::aes_mul(to_aes[a], to_aes[b])];
+	}
+	static const GaloisFieldAffine &instance()
+	{
+		static const GaloisFieldAffine affine;
+		return affine;
+	}
+};
+
+#endif
@@ -0,0 +1,66 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef INVERSIONLESS_BERLEKAMP_MASSEY_HH
+#define INVERSIONLESS_BERLEKAMP_MASSEY_HH
+
+#include <algorithm>
+#include "galois_field.hh"
+
+template <int NR, typename GF>
+struct InversionlessBerlekampMassey
+{
+	typedef typename GF::value_type value_type;
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	static const int N = GF::N, K = N - NR;
+	static const bool EVALUATOR = false;
+	static int algorithm(ValueType *s, ValueType *C, int count = 0, ValueType * = 0)
+	{
+		// $C = gamma * C - d * x^m * B$ only touches the coefficients up to the degrees of C and $x^m * B$
+		ValueType B[NR+1];
+		for (int i = 0; i <= count; ++i)
+			B[i] = C[i];
+		ValueType gamma(1);
+		int L = count, degree = count, B_degree = count;
+		for (int n = count, m = 1; n < NR; ++n) {
+			ValueType d(s[n] * C[0]);
+			for (int i = 1; i <= L; ++i)
+				d += C[i] * s[n-i];
+			if (!d) {
+				++m;
+				continue;
+			}
+			int T_degree = std::min(NR, std::max(degree, B_degree + m));
+			ValueType T[NR+1];
+			for (int i = 0; i <= T_degree; ++i)
+				T[i] = gamma * C[i];
+			for (int i = 0; i <= B_degree && i + m <= T_degree; ++i)
+				T[i+m] += d * B[i];
+			if (2 * L <= n + count) {
+				L = n + count + 1 - L;
+				for (int i = 0; i <= degree; ++i)
+					B[i] = C[i];
+				B_degree = degree;
+				gamma = d;
+				m = 1;
+			} else {
+				++m;
+			}
+			for (int i = 0; i <= T_degree; ++i)
+				C[i] = T[i];
+			degree = T_degree;
+		}
+		// a single inversion at the end to get $C_0 = 1$
+		IndexType scale(index(C[0]));
+		for (int i = 0; i <= degree; ++i)
+			C[i] = C[i] / scale;
+		return L;
+	}
+};
+
+#endif
@@ -0,0 +1,228 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef LIN_CHUNG_HAN_HH
+#define LIN_CHUNG_HAN_HH
+
+#include <vector>
+#include <algorithm>
+#include "galois_field.hh"
+
+/*
+Systematic erasure code over the points $\omega_j$ of GF(2^M) given by the bits of j,
+encoded and recovered with the additive FFT in the novel polynomial basis of Lin, Chung and Han.
+Every symbol is a shard of length field elements and all arithmetic is done shard wise,
+so encoding costs $O(K \log NR)$ and recovery $O(n \log n)$ shard operations.
+Parity shard i sits at point i and data shard i at point NR' + i, with NR' the parity count rounded up to a power of two.
+*/
+template <typename GF>
+class LinChungHan
+{
+public:
+	typedef typename GF::value_type value_type;
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	static const int M = GF::M, Q = GF::Q, N = GF::N;
+private:
+	// $skews_j = \hat{W}_m(\omega_{j+1})$ for the layer m of the butterfly at j
+	ValueType skews[Q];
+	// $derivatives_j = \prod_{i \in j} \hat{W}_{i+1}'$, the constant factors the formal derivative picks up
+	IndexType derivatives[Q/2];
+	static int pow2(int size)
+	{
+		int tmp = 1;
+		while (tmp < size)
+			tmp <<= 1;
+		return tmp;
+	}
+	static void add(ValueType *a, const ValueType *b, int length)
+	{
+		for (int w = 0; w < length; ++w)
+			a[w] += b[w];
+	}
+	static void fma(ValueType *a, IndexType factor, const ValueType *b, int length)
+	{
+		for (int w = 0; w < length; ++w)
+			a[w] += factor * b[w];
+	}
+	static void scale(ValueType *a, IndexType factor, int length)
+	{
+		for (int w = 0; w < length; ++w)
+			a[w] *= factor;
+	}
+	// from the values at the points $\omega_{offset} .. \omega_{offset+size-1}$ to the coefficients
+	void ifft(ValueType *data, int size, int offset, int length)
+	{
+		for (int dist = 1; dist < size; dist <<= 1) {
+			for (int j = dist; j < size; j += 2 * dist) {
+				ValueType skew(skews[j+offset-1]);
+				for (int i = j - dist; i < j; ++i) {
+					add(data + (i + dist) * length, data + i * length, length);
+					if (skew)
+						fma(data + i * length, index(skew), data + (i + dist) * length, length);
+				}
+			}
+		}
+	}
+	// and back again
+	void fft(ValueType *data, int size, int offset, int length)
+	{
+		for (int dist = size / 2; dist > 0; dist >>= 1) {
+			for (int j = dist; j < size; j += 2 * dist) {
+				ValueType skew(skews[j+offset-1]);
+				for (int i = j - dist; i < j; ++i) {
+					if (skew)
+						fma(data + i * length, index(skew), data + (i + dist) * length, length);
+					add(data + (i + dist) * length, data + i * length, length);
+				}
+			}
+		}
+	}
+	// fast Walsh-Hadamard transform modulo N, its own inverse up to a factor of size
+	static void walsh(int *data, int size)
+	{
+		for (int dist = 1; dist < size; dist <<= 1) {
+			for (int j = 0; j < size; j += 2 * dist) {
+				for (int i = j; i < j + dist; ++i) {
+					int a = data[i], b = data[i+dist];
+					data[i] = (a + b) % N;
+					data[i+dist] = (a + N - b) % N;
+				}
+			}
+		}
+	}
+public:
+	LinChungHan()
+	{
+		// basis $v_i = x^i$, $\hat{W}_m$ vanishes on the span of $v_0 .. v_{m-1}$ and is one at $v_m$
+		ValueType base[M-1];
+		for (int i = 1; i < M; ++i)
+			base[i-1] = ValueType(1 << i);
+		IndexType factors[M-1];
+		for (int j = 0; j < Q; ++j)
+			skews[j] = ValueType(0);
+		for (int m = 0; m < M - 1; ++m) {
+			// $\hat{W}_m$ is linear over GF(2), so its values at the points follow from those at the basis
+			int step = 1 << (m + 1);
+			for (int i = m; i < M - 1; ++i) {
+				int s = 1 << (i + 1);
+				for (int j = (1 << m) - 1; j < s; j += step)
+					skews[j+s] = skews[j] + base[i];
+			}
+			// $\hat{W}_{m+1}(x) = \frac{\hat{W}_m(x)(\hat{W}_m(x)+1)}{\hat{W}_m(v_{m+1})(\hat{W}_m(v_{m+1})+1)}$
+			ValueType normalize(base[m] * (base[m] + ValueType(1)));
+			factors[m] = index(normalize);
+			for (int i = m + 1; i < M - 1; ++i)
+				base[i] = base[i] * (base[i] + ValueType(1)) / normalize;
+		}
+		// $\hat{W}_{m+1}' = \hat{W}_m' / normalize_m$, as the derivative of $\hat{W}_m^2$ vanishes
+		for (int m = 1; m < M - 1; ++m)
+			factors[m] *= factors[m-1];
+		derivatives[0] = IndexType(0);
+		for (int i = 0; i < M - 1; ++i)
+			for (int j = 0; j < 1 << i; ++j)
+				derivatives[j+(1<<i)] = derivatives[j] / factors[i];
+	}
+	// computes parity_count parity shards from data_count data shards, each of length field elements
+	void encode(const value_type *const *data, int data_count, value_type *const *parity, int parity_count, int length)
+	{
+		assert(0 < data_count && 0 < parity_count);
+		int size = pow2(parity_count);
+		assert(size + data_count <= Q);
+		// $parity = FFT(\sum_i IFFT(data_i))$ over the chunks of size data shards at the points $size (i + 1)$
+		std::vector<ValueType> sum(size * length, ValueType(0)), chunk(size * length);
+		for (int offset = 0; offset < data_count; offset += size) {
+			for (int i = 0; i < size; ++i) {
+				ValueType *shard = chunk.data() + i * length;
+				if (offset + i < data_count)
+					std::copy(reinterpret_cast<const ValueType *>(data[offset+i]), reinterpret_cast<const ValueType *>(data[offset+i]) + length, shard);
+				else
+					std::fill(shard, shard + length, ValueType(0));
+			}
+			ifft(chunk.data(), size, size + offset, length);
+			add(sum.data(), chunk.data(), size * length);
+		}
+		fft(sum.data(), size, 0, length);
+		for (int i = 0; i < parity_count; ++i)
+			std::copy(sum.data() + i * length, sum.data() + (i + 1) * length, reinterpret_cast<ValueType *>(parity[i]));
+	}
+	// restores the shards listed in erasures, counting data shards first and parity shards after them
+	// returns the number of restored shards or -1 if there are more erasures than parity shards
+	int decode(value_type *const *data, int data_count, value_type *const *parity, int parity_count, int length, const int *erasures, int erasures_count)
+	{
+		assert(0 < data_count && 0 < parity_count);
+		assert(0 <= erasures_count);
+		if (erasures_count > parity_count)
+			return -1;
+		if (!erasures_count)
+			return 0;
+		int size = pow2(parity_count), n = pow2(size + data_count);
+		assert(n <= Q);
+		auto point = [size, data_count](int shard) { return shard < data_count ? size + shard : shard - data_count; };
+		auto shard = [&](int point) -> ValueType * {
+			if (point < size)
+				return point < parity_count ? reinterpret_cast<ValueType *>(parity[point]) : 0;
+			return point - size < data_count ? reinterpret_cast<ValueType *>(data[point-size]) : 0;
+		};
+		// the parity shards past parity_count were never stored, so they count as erasures
+		std::vector<int> erased(n, 0);
+		for (int i = parity_count; i < size; ++i)
+			erased[i] = 1;
+		for (int i = 0; i < erasures_count; ++i) {
+			assert(0 <= erasures[i] && erasures[i] < data_count + parity_count);
+			erased[point(erasures[i])] = 1;
+		}
+		// $locator(\omega_i) = \prod_{j \in erased}(\omega_i+\omega_j)$ in the log domain as a dyadic convolution,
+		// with the factor for j = i left out at the erased points, where it gives $locator'(\omega_i)$
+		std::vector<int> logs(n), locator(erased);
+		logs[0] = 0;
+		for (int i = 1; i < n; ++i)
+			logs[i] = (int)index(ValueType(i));
+		walsh(logs.data(), n);
+		walsh(locator.data(), n);
+		for (int i = 0; i < n; ++i)
+			locator[i] = (long long)locator[i] * logs[i] % N;
+		walsh(locator.data(), n);
+		// the transforms leave a factor of n, which is a power of two and $2^M = 1 \bmod{N}$
+		int rescale = (Q / n) % N;
+		for (int i = 0; i < n; ++i) {
+			locator[i] = (long long)locator[i] * rescale % N;
+			if (erased[i])
+				locator[i] = (N - locator[i]) % N;
+		}
+		// $work = IFFT(code \cdot locator)$, then the formal derivative and back again
+		std::vector<ValueType> work(n * length);
+		for (int i = 0; i < n; ++i) {
+			ValueType *tmp = work.data() + i * length, *src = shard(i);
+			if (erased[i] || !src)
+				std::fill(tmp, tmp + length, ValueType(0));
+			else
+				for (int w = 0; w < length; ++w)
+					tmp[w] = IndexType(locator[i]) * src[w];
+		}
+		ifft(work.data(), n, 0, length);
+		for (int i = 0; i < n; ++i)
+			scale(work.data() + i * length, derivatives[i/2], length);
+		for (int i = 1; i < n; ++i) {
+			int width = ((i ^ (i - 1)) + 1) >> 1;
+			add(work.data() + (i - width) * length, work.data() + i * length, width * length);
+		}
+		for (int i = 0; i < n; ++i)
+			scale(work.data() + i * length, rcp(derivatives[i/2]), length);
+		fft(work.data(), n, 0, length);
+		// $code_i = \frac{(code \cdot locator)'(\omega_i)}{locator'(\omega_i)}$ at the erased points
+		for (int i = 0; i < erasures_count; ++i) {
+			int j = point(erasures[i]);
+			ValueType *dst = shard(j), *src = work.data() + j * length;
+			for (int w = 0; w < length; ++w)
+				dst[w] = IndexType(locator[j]) * src[w];
+		}
+		return erasures_count;
+	}
+};
+
+#endif
@@ -0,0 +1,87 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef PARALLEL_DECODING_HH
+#define PARALLEL_DECODING_HH
+
+#include <vector>
+#include <algorithm>
+#include "galois_field.hh"
+#include "syndromes.hh"
+#include "chien.hh"
+#include "find_locations.hh"
+#include "thread_pool.hh"
+#include "decoder_stats.hh"
+
+// the position dependent stages of decoding a single long codeword, split over the threads of a pool
+template <int NR, int FCR, typename GF>
+struct ParallelDecoding
+{
+	typedef typename GF::value_type value_type;
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	static const int N = GF::N, MIN_RANGE = 4096;
+	static int parts(ThreadPool &pool, int length, int min_range = MIN_RANGE)
+	{
+		// ranges too short are not worth the synchronization
+		return std::max(1, std::min(pool.threads_count(), length / min_range));
+	}
+	/*
+	partial(begin, end, out) puts $root^{offset}\sum_{j=begin}^{end-1} code_j\,root^{end-1-j}$ for all NR roots into out,
+	which are then scaled by $root^{length-end-offset}$ to their place in $code(root)$
+	*/
+	template <typename PARTIAL>
+	static int syndromes(ThreadPool &pool, ValueType *syndromes, int length, int min_range, int offset, PARTIAL partial)
+	{
+		int count = parts(pool, length, min_range);
+		std::vector<ValueType> partials(count * NR);
+		pool.run(count, [&](int p) {
+			int begin = (long long)length * p / count, end = (long long)length * (p + 1) / count;
+			partial(begin, end, partials.data() + p * NR);
+		});
+		for (int i = 0; i < NR; ++i)
+			syndromes[i] = ValueType(0);
+		for (int p = 0; p < count; ++p) {
+			int end = (long long)length * (p + 1) / count;
+			int shift = ((length - end - offset) % N + N) % N;
+			for (int i = 0; i < NR; ++i)
+				syndromes[i] += IndexType((long long)((FCR + i) % N + N) * shift % N) * partials[p*NR+i];
+		}
+		int nonzero = 0;
+		for (int i = 0; i < NR; ++i)
+			nonzero += !!syndromes[i];
+		return nonzero;
+	}
+	static int syndromes(ThreadPool &pool, ValueType *code, ValueType *syndromes, int length)
+	{
+		return ParallelDecoding::syndromes(pool, syndromes, length, MIN_RANGE, 0,
+			[code](int begin, int end, ValueType *partial) {
+				Syndromes<NR, FCR, GF>::compute(code + begin, partial, end - begin);
+			});
+	}
+	static int search(ThreadPool &pool, ValueType *locator, int locator_degree, IndexType *locations, int first = 0)
+	{
+		// closed forms for the small degrees, the Chien search over ranges of positions otherwise
+		if (locator_degree <= 4)
+			return FindLocations<NR, GF>::search(locator, locator_degree, locations, first);
+		DECODER_STATS_STAGE(CHIEN);
+		int count = parts(pool, N - first);
+		std::vector<IndexType> found(count * NR);
+		std::vector<int> counts(count);
+		pool.run(count, [&](int p) {
+			int begin = first + (long long)(N - first) * p / count, end = first + (long long)(N - first) * (p + 1) / count;
+			counts[p] = Chien<NR, GF>::search(locator, locator_degree, found.data() + p * NR, begin, end);
+		});
+		int total = 0;
+		for (int p = 0; p < count; ++p)
+			for (int i = 0; i < counts[p] && total < locator_degree; ++i)
+				locations[total++] = found[p*NR+i];
+		return total;
+	}
+};
+
+#endif
@@ -8,17 +8,26 @@ You should have received a copy of the CC0 Public Domain Dedication along with t
 #ifndef REED_SOLOMON_HH
 #define REED_SOLOMON_HH
 
+#include <algorithm>
+#include <type_traits>
 #include "galois_field.hh"
+#include "gfni.hh"
 #include "correction.hh"
+#include "constant_time_correction.hh"
+#include "syndromes.hh"
+#include "parallel_decoding.hh"
+#include "decoder_stats.hh"
 
-template <int NR, int FCR, typename GF>
+template <int NR, int FCR, typename GF, int LENGTH = GF::N, template <int, typename> class SOLVER = BerlekampMassey>
 class ReedSolomon
 {
 public:
 	typedef typename GF::value_type value_type;
 	typedef typename GF::ValueType ValueType;
 	typedef typename GF::IndexType IndexType;
-	static const int N = GF::N, K = N - NR;
+	// shortened codes omit the first SHORTENED symbols, which are implicitly zero
+	static const int N = LENGTH, K = N - NR, SHORTENED = GF::N - N;
+	static_assert(NR < N && N <= GF::N, "LENGTH out of range");
 	IndexType generator[NR+1];
 	ReedSolomon()
 	{
@@ -50,68 +59,307 @@ public:
 		for (int i = 0; i <= NR; ++i)
 			generator[i] = index(tmp[i]);
 	}
-	void encode(ValueType *code)
+private:
+	struct Products
 	{
-		// $code = data * x^{NR} + (data * x^{NR}) \mod{generator}$
-		for (int i = 0; i < NR; ++i)
-			code[K+i] = ValueType(0);
-		for (int i = 0; i < K; ++i) {
-			ValueType feedback = code[i] + code[K];
-			if (feedback) {
-				IndexType fb = index(feedback);
-				for (int j = 1; j < NR; ++j)
-					code[K+j-1] = fma(fb, generator[NR-j], code[K+j]);
-				code[N-1] = value(generator[0] * fb);
-			} else {
-				for (int j = 1; j < NR; ++j)
-					code[K+j-1] = code[K+j];
-				code[N-1] = ValueType(0);
+		// $table_{fb,j} = fb * generator_{NR-1-j}$
+		ValueType table[GF::Q * NR];
+		explicit Products(const IndexType *gen)
+		{
+			for (int j = 0; j < NR; ++j)
+				table[j] = ValueType(0);
+			for (int i = 1; i < GF::Q; ++i) {
+				IndexType fb = index(ValueType(i));
+				for (int j = 0; j < NR; ++j)
+					table[NR*i+j] = value(fb * gen[NR-1-j]);
 			}
 		}
+	};
+#ifdef GFNI_KERNELS
+	struct Affine
+	{
+		bool supported;
+		// $generator_j = generator_{NR-1-j}$ mapped into the AES field for GF2P8MULB
+		uint8_t generator[64];
+		explicit Affine(const IndexType *gen) : supported(GaloisFieldNewInstructions::supported())
+		{
+			const GaloisFieldAffine<GF> &field = GaloisFieldAffine<GF>::instance();
+			for (int j = 0; j < 64; ++j)
+				generator[j] = j < NR ? field.to_aes[(int)value(gen[NR-1-j])] : 0;
+		}
+	};
+	void encode(const ValueType *data, ValueType *parity, int stride, std::true_type)
+	{
+		static const Affine affine(generator);
+		if (!affine.supported)
+			return encode(data, parity, stride, std::false_type());
+		const GaloisFieldAffine<GF> &field = GaloisFieldAffine<GF>::instance();
+		GaloisFieldNewInstructions::encode(reinterpret_cast<const uint8_t *>(data), K, stride, affine.generator, field.to_aes, field.from_aes, NR, reinterpret_cast<uint8_t *>(parity));
 	}
-	int compute_syndromes(ValueType *code, ValueType *syndromes)
+#endif
+	void encode(const ValueType *data, ValueType *parity, int stride, std::false_type)
 	{
-		// $syndromes_i = code(pe^{FCR+i})$
-		for (int i = 0; i < NR; ++i)
-			syndromes[i] = code[0];
-		for (int j = 1; j < N; ++j) {
-			IndexType root(FCR), pe(1);
-			for (int i = 0; i < NR; ++i) {
-				syndromes[i] = fma(root, syndromes[i], code[j]);
-				root *= pe;
-			}
+		// $parity = (data * x^{NR}) \mod{generator}$
+		static const Products products(generator);
+		ValueType tmp[NR];
+		for (int j = 0; j < NR; ++j)
+			tmp[j] = ValueType(0);
+		for (int i = 0; i < K; ++i) {
+			const ValueType *row = products.table + NR * (int)(data[i*stride] + tmp[0]);
+			for (int j = 1; j < NR; ++j)
+				tmp[j-1] = tmp[j] + row[j-1];
+			tmp[NR-1] = row[NR-1];
 		}
+		for (int j = 0; j < NR; ++j)
+			parity[j*stride] = tmp[j];
+	}
+	void encode(const ValueType *data, ValueType *parity, int stride)
+	{
+#ifdef GFNI_KERNELS
+		encode(data, parity, stride, std::integral_constant<bool, GF::M == 8 && sizeof(value_type) == 1 && NR <= 64>());
+#else
+		encode(data, parity, stride, std::false_type());
+#endif
+	}
+	// applies the corrections the syndromes ask for to the codeword with symbol i at code[i*stride],
+	// if track is set the syndromes follow along, so they still belong to the code afterwards
+	int correct(ValueType *code, int stride, ValueType *syndromes, IndexType *erasures, int erasures_count, bool track = false)
+	{
+		return correct(code, stride, syndromes, erasures, erasures_count, track, FindLocations<NR, GF>::search);
+	}
+	// search(locator, locator_degree, locations, first) finds the roots of the locator
+	template <typename SEARCH>
+	int correct(ValueType *code, int stride, ValueType *syndromes, IndexType *erasures, int erasures_count, bool track, SEARCH search)
+	{
+		IndexType locations[NR];
+		ValueType magnitudes[NR];
+		int count = Correction<NR, FCR, GF, SOLVER>::algorithm(syndromes, locations, magnitudes, erasures, erasures_count, SHORTENED, search);
+		if (count <= 0) {
+			DECODER_STATS_OUTCOME(count);
+			return count;
+		}
+		for (int i = 0; i < count; ++i)
+			code[(int)locations[i]*stride] += magnitudes[i];
+		if (track)
+			for (int i = 0; i < count; ++i)
+				update_syndromes(syndromes, (int)locations[i], magnitudes[i]);
+		int corrections_count = 0;
+		for (int i = 0; i < count; ++i)
+			corrections_count += !!magnitudes[i];
+		DECODER_STATS_OUTCOME(corrections_count);
+		return corrections_count;
+	}
+public:
+	void encode(const ValueType *data, ValueType *parity)
+	{
+		encode(data, parity, 1);
+	}
+	void encode(ValueType *code)
+	{
+		// $code = data * x^{NR} + (data * x^{NR}) \mod{generator}$
+		encode(code, code + K, 1);
+	}
+	// symbol i of the codeword is at code[i*stride], e.g. a column of an interleaved frame
+	void encode(ValueType *code, int stride)
+	{
+		encode(code, code + K * stride, stride);
+	}
+	bool check(const ValueType *code)
+	{
+		// clean codewords reproduce their parity, which is cheaper than NR syndromes
+		ValueType parity[NR];
+		encode(code, parity);
+		int diff = 0;
+		for (int j = 0; j < NR; ++j)
+			diff |= (int)(parity[j] + code[K+j]);
+		return !diff;
+	}
+	int compute_syndromes(ValueType *code, ValueType *syndromes)
+	{
+		DECODER_STATS_STAGE(SYNDROMES);
+		return Syndromes<NR, FCR, GF>::compute(code, syndromes, N);
+	}
+	int compute_syndromes(ValueType *code, ValueType *syndromes, int stride)
+	{
+		if (stride == 1)
+			return compute_syndromes(code, syndromes);
+		DECODER_STATS_STAGE(SYNDROMES);
+		Syndromes<NR, FCR, GF>::compute(code, syndromes, N, stride, 1);
 		int nonzero = 0;
 		for (int i = 0; i < NR; ++i)
 			nonzero += !!syndromes[i];
 		return nonzero;
 	}
+	// syndromes of the depth codewords of an interleaved frame, symbol i of codeword d is at frame[i*depth+d]
+	// and its syndromes start at syndromes + d*NR, returns the number of codewords with nonzero syndromes
+	int compute_syndromes_interleaved(ValueType *frame, ValueType *syndromes, int depth)
+	{
+		DECODER_STATS_STAGE(SYNDROMES);
+		return Syndromes<NR, FCR, GF>::compute(frame, syndromes, N, depth, depth);
+	}
 	int decode(ValueType *code, IndexType *erasures = 0, int erasures_count = 0)
+	{
+		return decode(code, 1, erasures, erasures_count);
+	}
+	int decode(ValueType *code, int stride, IndexType *erasures = 0, int erasures_count = 0)
 	{
 		assert(0 <= erasures_count && erasures_count <= NR);
 #if 0
 		for (int i = 0; i < erasures_count; ++i)
-			code[(int)erasures[i]] = ValueType(0);
+			code[(int)erasures[i]*stride] = ValueType(0);
 #endif
 		ValueType syndromes[NR];
-		if (!compute_syndromes(code, syndromes))
+		if (!compute_syndromes(code, syndromes, stride)) {
+			DECODER_STATS_OUTCOME(0);
 			return 0;
+		}
+		return correct(code, stride, syndromes, erasures, erasures_count);
+	}
+	/*
+	Decodes the depth codewords of an interleaved frame in place, symbol i of codeword d is at frame[i*depth+d].
+	The syndromes of neighbouring codewords are computed side by side, only the dirty ones go through the rest.
+	If given, results[d] receives the result of codeword d.
+	Returns the number of corrected symbols or -1 if any codeword was not correctable.
+	*/
+	int decode_interleaved(ValueType *frame, int depth, int *results = 0)
+	{
+		const int GROUP = 64;
+		ValueType syndromes[GROUP*NR];
+		int corrections = 0;
+		bool failed = false;
+		for (int g = 0; g < depth; g += GROUP) {
+			int columns = std::min(GROUP, depth - g);
+			{
+				DECODER_STATS_STAGE(SYNDROMES);
+				Syndromes<NR, FCR, GF>::compute(frame + g, syndromes, N, depth, columns);
+			}
+			for (int d = 0; d < columns; ++d) {
+				int nonzero = 0;
+				for (int i = 0; i < NR; ++i)
+					nonzero |= !!syndromes[d*NR+i];
+				int result = 0;
+				if (nonzero) {
+					result = correct(frame + g + d, depth, syndromes + d * NR, 0, 0);
+				} else {
+					DECODER_STATS_OUTCOME(0);
+				}
+				if (results)
+					results[g+d] = result;
+				if (result < 0)
+					failed = true;
+				else
+					corrections += result;
+			}
+		}
+		return failed ? -1 : corrections;
+	}
+	// $syndromes_i$ += $delta\,pe^{(FCR+i)(N-1-position)}$, as code[position] holds the coefficient of $x^{N-1-position}$
+	void update_syndromes(ValueType *syndromes, int position, ValueType delta)
+	{
+		assert(0 <= position && position < N);
+		if (!delta)
+			return;
+		int exponent = N - 1 - position;
+		IndexType step(exponent), term(index(delta) * IndexType((long long)FCR * exponent % GF::N));
+		for (int i = 0; i < NR; ++i, term *= step)
+			syndromes[i] += value(term);
+	}
+	// puts symbol at code[position] and keeps the syndromes of code up to date in $O(NR)$
+	void replace_symbol(ValueType *code, ValueType *syndromes, int position, ValueType symbol)
+	{
+		update_syndromes(syndromes, position, code[position] + symbol);
+		code[position] = symbol;
+	}
+	/*
+	Same as decode, but starts from syndromes that already belong to code,
+	e.g. kept up to date with replace_symbol while a failed block gets repaired piece by piece.
+	On success the syndromes follow the corrections, so they stay valid for the next attempt.
+	*/
+	int decode_syndromes(ValueType *code, ValueType *syndromes, IndexType *erasures = 0, int erasures_count = 0)
+	{
+		assert(0 <= erasures_count && erasures_count <= NR);
+		int nonzero = 0;
+		for (int i = 0; i < NR; ++i)
+			nonzero |= !!syndromes[i];
+		if (!nonzero) {
+			DECODER_STATS_OUTCOME(0);
+			return 0;
+		}
+		return correct(code, 1, syndromes, erasures, erasures_count, true);
+	}
+	int decode_constant_time(ValueType *code, IndexType *erasures = 0, int erasures_count = 0)
+	{
+		// same work for every block, no matter if it is clean or how many errors it has
+		ValueType syndromes[NR];
+		compute_syndromes(code, syndromes);
 		IndexType locations[NR];
 		ValueType magnitudes[NR];
-		int count = Correction<NR, FCR, GF>::algorithm(syndromes, locations, magnitudes, erasures, erasures_count);
-		if (count <= 0)
-			return count;
-		for (int i = 0; i < count; ++i)
-			code[(int)locations[i]] += magnitudes[i];
+		int count = ConstantTimeCorrection<NR, FCR, GF>::algorithm(syndromes, locations, magnitudes, erasures, erasures_count, SHORTENED);
+		int invalid = count < 0;
 		int corrections_count = 0;
-		for (int i = 0; i < count; ++i)
-			corrections_count += !!magnitudes[i];
-		return corrections_count;
+		for (int i = 0; i < NR; ++i) {
+			ValueType magnitude(invalid ? ValueType(0) : magnitudes[i]);
+			code[(int)locations[i]] += magnitude;
+			corrections_count += !!magnitude;
+		}
+		DECODER_STATS_OUTCOME(invalid ? -1 : corrections_count);
+		return invalid ? -1 : corrections_count;
+	}
+	int decode_fast(ValueType *code, IndexType *erasures = 0, int erasures_count = 0)
+	{
+		if (check(code)) {
+			DECODER_STATS_OUTCOME(0);
+			return 0;
+		}
+		return decode(code, erasures, erasures_count);
+	}
+	int compute_syndromes_parallel(ValueType *code, ValueType *syndromes, ThreadPool &pool)
+	{
+		DECODER_STATS_STAGE(SYNDROMES);
+		return ParallelDecoding<NR, FCR, GF>::syndromes(pool, code, syndromes, N);
+	}
+	int decode_parallel(ValueType *code, ThreadPool &pool, IndexType *erasures = 0, int erasures_count = 0)
+	{
+		// same as decode, but the syndromes and the Chien search of this single codeword are spread over the pool
+		assert(0 <= erasures_count && erasures_count <= NR);
+		ValueType syndromes[NR];
+		if (!compute_syndromes_parallel(code, syndromes, pool)) {
+			DECODER_STATS_OUTCOME(0);
+			return 0;
+		}
+		return correct(code, 1, syndromes, erasures, erasures_count, false,
+			[&pool](ValueType *locator, int locator_degree, IndexType *locations, int first) {
+				return ParallelDecoding<NR, FCR, GF>::search(pool, locator, locator_degree, locations, first);
+			});
 	}
 	void encode(value_type *code)
 	{
 		encode(reinterpret_cast<ValueType *>(code));
 	}
+	void encode(value_type *code, int stride)
+	{
+		encode(reinterpret_cast<ValueType *>(code), stride);
+	}
+	bool check(const value_type *code)
+	{
+		return check(reinterpret_cast<const ValueType *>(code));
+	}
+	int decode_constant_time(value_type *code, value_type *erasures = 0, int erasures_count = 0)
+	{
+		return decode_constant_time(reinterpret_cast<ValueType *>(code), reinterpret_cast<IndexType *>(erasures), erasures_count);
+	}
+	int decode_fast(value_type *code, value_type *erasures = 0, int erasures_count = 0)
+	{
+		return decode_fast(reinterpret_cast<ValueType *>(code), reinterpret_cast<IndexType *>(erasures), erasures_count);
+	}
+	int decode_parallel(value_type *code, ThreadPool &pool, value_type *erasures = 0, int erasures_count = 0)
+	{
+		return decode_parallel(reinterpret_cast<ValueType *>(code), pool, reinterpret_cast<IndexType *>(erasures), erasures_count);
+	}
+	int compute_syndromes_parallel(value_type *code, value_type *syndromes, ThreadPool &pool)
+	{
+		return compute_syndromes_parallel(reinterpret_cast<ValueType *>(code), reinterpret_cast<ValueType *>(syndromes), pool);
+	}
 	int decode(value_type *code, value_type *erasures = 0, int erasures_count = 0)
 	{
 		return decode(reinterpret_cast<ValueType *>(code), reinterpret_cast<IndexType *>(erasures), erasures_count);
@@ -120,6 +368,34 @@ public:
 	{
 		return compute_syndromes(reinterpret_cast<ValueType *>(code), reinterpret_cast<ValueType *>(syndromes));
 	}
+	int decode(value_type *code, int stride, value_type *erasures = 0, int erasures_count = 0)
+	{
+		return decode(reinterpret_cast<ValueType *>(code), stride, reinterpret_cast<IndexType *>(erasures), erasures_count);
+	}
+	int compute_syndromes(value_type *code, value_type *syndromes, int stride)
+	{
+		return compute_syndromes(reinterpret_cast<ValueType *>(code), reinterpret_cast<ValueType *>(syndromes), stride);
+	}
+	int compute_syndromes_interleaved(value_type *frame, value_type *syndromes, int depth)
+	{
+		return compute_syndromes_interleaved(reinterpret_cast<ValueType *>(frame), reinterpret_cast<ValueType *>(syndromes), depth);
+	}
+	int decode_interleaved(value_type *frame, int depth, int *results = 0)
+	{
+		return decode_interleaved(reinterpret_cast<ValueType *>(frame), depth, results);
+	}
+	void update_syndromes(value_type *syndromes, int position, value_type delta)
+	{
+		update_syndromes(reinterpret_cast<ValueType *>(syndromes), position, ValueType(delta));
+	}
+	void replace_symbol(value_type *code, value_type *syndromes, int position, value_type symbol)
+	{
+		replace_symbol(reinterpret_cast<ValueType *>(code), reinterpret_cast<ValueType *>(syndromes), position, ValueType(symbol));
+	}
+	int decode_syndromes(value_type *code, value_type *syndromes, value_type *erasures = 0, int erasures_count = 0)
+	{
+		return decode_syndromes(reinterpret_cast<ValueType *>(code), reinterpret_cast<ValueType *>(syndromes), reinterpret_cast<IndexType *>(erasures), erasures_count);
+	}
 };
 
 #endif
@@ -0,0 +1,64 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef REFORMULATED_BERLEKAMP_MASSEY_HH
+#define REFORMULATED_BERLEKAMP_MASSEY_HH
+
+#include "galois_field.hh"
+
+template <int NR, typename GF>
+struct ReformulatedBerlekampMassey
+{
+	typedef typename GF::value_type value_type;
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	static const int N = GF::N, K = N - NR, ZERO = 2 * N, SIZE = 3 * NR + 1;
+	/*
+	Same work for any input: NR steps over all SIZE coefficients without divisions or data dependent branches.
+	$delta = (syndromes + x^{2NR}) * locator / x^n$ carries the discrepancy in $delta_0$ and the locator in its upper part,
+	$theta$ does the same for the correction polynomial, so both end up as $delta = evaluator_h + x^{NR} * locator$.
+	The first erasures_count steps only shift, which starts the iterations with the erasure locator in locator.
+	locator and evaluator are scaled by the same nonzero factor, evaluator is the high order evaluator
+	$evaluator_h = ((syndromes * locator) \div x^{NR}) \bmod{x^{NR}}$, needing $root^{NR}$ as an extra factor in Forney.
+	*/
+	static void algorithm(ValueType *syndromes, ValueType *locator, ValueType *evaluator, int erasures_count = 0)
+	{
+		ValueType delta[SIZE+1], theta[SIZE];
+		for (int i = 0; i <= SIZE; ++i)
+			delta[i] = ValueType(0);
+		for (int i = 0; i < NR; ++i)
+			for (int j = 0; j <= NR; ++j)
+				delta[i+j] += syndromes[i] * locator[j];
+		for (int j = 0; j <= NR; ++j)
+			delta[2*NR+j] = locator[j];
+		for (int i = 0; i < SIZE; ++i)
+			theta[i] = delta[i];
+		int gamma = 0, k = 0;
+		for (int n = 0; n < NR; ++n) {
+			// masks instead of branches, all ones when true
+			int shift = -(n < erasures_count);
+			int d = delta[0].exponent();
+			int discrepancy = (d & ~shift) | (ZERO & shift);
+			int swap = shift | (-(d != ZERO) & ~(k >> 31));
+			// $delta = gamma * delta / x - discrepancy * theta$ and $theta = delta / x$ on swap
+			for (int i = 0; i < SIZE; ++i) {
+				ValueType next(delta[i+1]);
+				delta[i] = ValueType::power(gamma + next.exponent()) + ValueType::power(discrepancy + theta[i].exponent());
+				theta[i] = ValueType(((int)next & swap) | ((int)theta[i] & ~swap));
+			}
+			int update = ~shift & swap;
+			gamma = (d & update) | (gamma & ~update);
+			k = (k & shift) | (~shift & ((~k & update) | ((k + 1) & ~update)));
+		}
+		for (int i = 0; i <= NR; ++i)
+			locator[i] = delta[NR+i];
+		for (int i = 0; i < NR; ++i)
+			evaluator[i] = delta[i];
+	}
+};
+
+#endif
@@ -0,0 +1,309 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef SYNDROMES_HH
+#define SYNDROMES_HH
+
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include "galois_field.hh"
+#include "gfni.hh"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SHUFFLE_SYNDROMES
+#endif
+
+#ifdef SHUFFLE_SYNDROMES
+struct ShuffleSyndromes
+{
+	// tables hold the low and high nibble products for $root^{2^t}$, $t = 0 \dots 6$
+	static const int POWERS = 7, TABLE = 32, STRIDE = POWERS * TABLE;
+	typedef void (*Kernel)(const uint8_t *, int, const uint8_t *, int, uint8_t *);
+	__attribute__((target("ssse3")))
+	static __m128i mul(__m128i x, const uint8_t *table)
+	{
+		__m128i mask = _mm_set1_epi8(15);
+		__m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)table), _mm_and_si128(x, mask));
+		__m128i hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 16)), _mm_and_si128(_mm_srli_epi16(x, 4), mask));
+		return _mm_xor_si128(lo, hi);
+	}
+	__attribute__((target("avx2")))
+	static __m256i mul(__m256i x, const uint8_t *table)
+	{
+		__m256i mask = _mm256_set1_epi8(15);
+		__m256i lo = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)table)), _mm256_and_si256(x, mask));
+		__m256i hi = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(table + 16))), _mm256_and_si256(_mm256_srli_epi16(x, 4), mask));
+		return _mm256_xor_si256(lo, hi);
+	}
+	__attribute__((target("avx512bw")))
+	static __m512i mul(__m512i x, const uint8_t *table)
+	{
+		__m512i mask = _mm512_set1_epi8(15);
+		__m512i lo = _mm512_shuffle_epi8(_mm512_maskz_broadcast_i32x4(-1, _mm_loadu_si128((const __m128i *)table)), _mm512_and_si512(x, mask));
+		__m512i hi = _mm512_shuffle_epi8(_mm512_maskz_broadcast_i32x4(-1, _mm_loadu_si128((const __m128i *)(table + 16))), _mm512_and_si512(_mm512_srli_epi16(x, 4), mask));
+		return _mm512_xor_si512(lo, hi);
+	}
+	// lane k holds the sum for $root^{W-1-k}$, so fold the upper halves onto the lower ones
+	__attribute__((target("ssse3")))
+	static uint8_t fold(__m128i acc, const uint8_t *tables)
+	{
+		acc = _mm_xor_si128(mul(acc, tables + 3 * TABLE), _mm_srli_si128(acc, 8));
+		acc = _mm_xor_si128(mul(acc, tables + 2 * TABLE), _mm_srli_si128(acc, 4));
+		acc = _mm_xor_si128(mul(acc, tables + 1 * TABLE), _mm_srli_si128(acc, 2));
+		acc = _mm_xor_si128(mul(acc, tables), _mm_srli_si128(acc, 1));
+		return _mm_cvtsi128_si32(acc);
+	}
+	__attribute__((target("avx2")))
+	static uint8_t fold(__m256i acc, const uint8_t *tables)
+	{
+		return fold(_mm_xor_si128(mul(_mm256_castsi256_si128(acc), tables + 4 * TABLE), _mm256_extracti128_si256(acc, 1)), tables);
+	}
+	__attribute__((target("avx512bw")))
+	static uint8_t fold(__m512i acc, const uint8_t *tables)
+	{
+		return fold(_mm256_xor_si256(mul(_mm512_maskz_extracti64x4_epi64(-1, acc, 0), tables + 5 * TABLE), _mm512_maskz_extracti64x4_epi64(-1, acc, 1)), tables);
+	}
+	// leading zeros do not change the result, so pad the first chunk in front
+	__attribute__((target("ssse3")))
+	static void ssse3(const uint8_t *code, int length, const uint8_t *tables, int roots, uint8_t *syndromes)
+	{
+		const int W = 16;
+		int head = length % W;
+		uint8_t first[W] = { 0 };
+		for (int i = 0; i < head; ++i)
+			first[W-head+i] = code[i];
+		for (int i = 0; i < roots; ++i, tables += STRIDE) {
+			__m128i acc = _mm_loadu_si128((const __m128i *)first);
+			for (int j = head; j < length; j += W)
+				acc = _mm_xor_si128(mul(acc, tables + 4 * TABLE), _mm_loadu_si128((const __m128i *)(code + j)));
+			syndromes[i] = fold(acc, tables);
+		}
+	}
+	__attribute__((target("avx2")))
+	static void avx2(const uint8_t *code, int length, const uint8_t *tables, int roots, uint8_t *syndromes)
+	{
+		const int W = 32;
+		int head = length % W;
+		uint8_t first[W] = { 0 };
+		for (int i = 0; i < head; ++i)
+			first[W-head+i] = code[i];
+		for (int i = 0; i < roots; ++i, tables += STRIDE) {
+			__m256i acc = _mm256_loadu_si256((const __m256i *)first);
+			for (int j = head; j < length; j += W)
+				acc = _mm256_xor_si256(mul(acc, tables + 5 * TABLE), _mm256_loadu_si256((const __m256i *)(code + j)));
+			syndromes[i] = fold(acc, tables);
+		}
+	}
+	__attribute__((target("avx512bw")))
+	static void avx512bw(const uint8_t *code, int length, const uint8_t *tables, int roots, uint8_t *syndromes)
+	{
+		const int W = 64;
+		int head = length % W;
+		uint8_t first[W] = { 0 };
+		for (int i = 0; i < head; ++i)
+			first[W-head+i] = code[i];
+		for (int i = 0; i < roots; ++i, tables += STRIDE) {
+			__m512i acc = _mm512_loadu_si512((const void *)first);
+			for (int j = head; j < length; j += W)
+				acc = _mm512_xor_si512(mul(acc, tables + 6 * TABLE), _mm512_loadu_si512((const void *)(code + j)));
+			syndromes[i] = fold(acc, tables);
+		}
+	}
+	// syndromes of the columns adjacent codewords of an interleaved frame, symbol j of codeword d is at code[j*stride+d]
+	// and its syndromes end up at syndromes + d*roots, each lane of a vector follows one codeword through Horner
+	typedef void (*Interleaved)(const uint8_t *, int, int, int, const uint8_t *, int, uint8_t *);
+	__attribute__((target("avx2")))
+	static void avx2_interleaved(const uint8_t *code, int length, int stride, int columns, const uint8_t *tables, int roots, uint8_t *syndromes)
+	{
+		const int W = 32, BLOCK = 4;
+		for (int c = 0; c < columns; c += W) {
+			int lanes = std::min(W, columns - c);
+			// a few roots at a time, so the products are independent of each other
+			for (int i = 0; i < roots; i += BLOCK) {
+				__m256i acc[BLOCK];
+				const uint8_t *table[BLOCK];
+				for (int k = 0; k < BLOCK; ++k) {
+					acc[k] = _mm256_setzero_si256();
+					table[k] = tables + std::min(i + k, roots - 1) * STRIDE;
+				}
+				for (int j = 0; j < length; ++j) {
+					__m256i symbols;
+					if (lanes == W) {
+						symbols = _mm256_loadu_si256((const __m256i *)(code + j * stride + c));
+					} else {
+						uint8_t tmp[W] = { 0 };
+						std::copy(code + j * stride + c, code + j * stride + c + lanes, tmp);
+						symbols = _mm256_loadu_si256((const __m256i *)tmp);
+					}
+					for (int k = 0; k < BLOCK; ++k)
+						acc[k] = _mm256_xor_si256(mul(acc[k], table[k]), symbols);
+				}
+				uint8_t tmp[W];
+				for (int k = 0; k < BLOCK && i + k < roots; ++k) {
+					_mm256_storeu_si256((__m256i *)tmp, acc[k]);
+					for (int l = 0; l < lanes; ++l)
+						syndromes[(c+l)*roots+i+k] = tmp[l];
+				}
+			}
+		}
+	}
+	static Interleaved interleaved()
+	{
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return avx2_interleaved;
+		return 0;
+	}
+	static Kernel kernel()
+	{
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512bw"))
+			return avx512bw;
+		if (__builtin_cpu_supports("avx2"))
+			return avx2;
+		if (__builtin_cpu_supports("ssse3"))
+			return ssse3;
+		return 0;
+	}
+};
+#endif
+
+template <int NR, int FCR, typename GF>
+struct Syndromes
+{
+	typedef typename GF::value_type value_type;
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	static const int N = GF::N;
+	static void horner(ValueType *code, ValueType *syndromes, int length)
+	{
+		// $syndromes_i = code(pe^{FCR+i})$, shortened codes start with implicit zeros
+		IndexType roots[NR], pe(1);
+		roots[0] = IndexType(FCR);
+		for (int i = 1; i < NR; ++i)
+			roots[i] = roots[i-1] * pe;
+		for (int i = 0; i < NR; ++i)
+			syndromes[i] = code[0];
+		for (int j = 1; j < length; ++j)
+			for (int i = 0; i < NR; ++i)
+				syndromes[i] = fma(roots[i], syndromes[i], code[j]);
+	}
+	static void horner(ValueType *code, ValueType *syndromes, int length, int stride, int columns)
+	{
+		// the same for the codewords of an interleaved frame, symbol j of codeword d is at code[j*stride+d]
+		for (int d = 0; d < columns; ++d)
+			for (int i = 0; i < NR; ++i)
+				syndromes[d*NR+i] = code[d];
+		IndexType roots[NR], pe(1);
+		roots[0] = IndexType(FCR);
+		for (int i = 1; i < NR; ++i)
+			roots[i] = roots[i-1] * pe;
+		for (int j = 1; j < length; ++j)
+			for (int d = 0; d < columns; ++d)
+				for (int i = 0; i < NR; ++i)
+					syndromes[d*NR+i] = fma(roots[i], syndromes[d*NR+i], code[j*stride+d]);
+	}
+#ifdef SHUFFLE_SYNDROMES
+	struct Shuffle
+	{
+		ShuffleSyndromes::Kernel kernel;
+		ShuffleSyndromes::Interleaved interleaved;
+		uint8_t tables[NR * ShuffleSyndromes::STRIDE];
+#ifdef GFNI_KERNELS
+		// the same powers as bit matrices for GF2P8AFFINEQB
+		bool affine;
+		uint64_t matrices[NR * ShuffleSyndromes::POWERS];
+#endif
+		Shuffle() : kernel(ShuffleSyndromes::kernel()), interleaved(ShuffleSyndromes::interleaved())
+		{
+			IndexType root(FCR), pe(1);
+			for (int i = 0; i < NR; ++i, root *= pe) {
+				IndexType power(root);
+				for (int t = 0; t < ShuffleSyndromes::POWERS; ++t, power *= power) {
+					uint8_t *table = tables + i * ShuffleSyndromes::STRIDE + t * ShuffleSyndromes::TABLE;
+					for (int x = 0; x < 16; ++x) {
+						table[x] = (int)(power * ValueType(x));
+						table[16+x] = x << 4 < GF::Q ? (int)(power * ValueType(x << 4)) : 0;
+					}
+#ifdef GFNI_KERNELS
+					matrices[i * ShuffleSyndromes::POWERS + t] = GaloisFieldNewInstructions::multiply<GF::M>(value(power));
+#endif
+				}
+			}
+#ifdef GFNI_KERNELS
+			affine = GaloisFieldNewInstructions::supported();
+#endif
+		}
+	};
+	static void compute(ValueType *code, ValueType *syndromes, int length, std::true_type)
+	{
+		static const Shuffle shuffle;
+#ifdef GFNI_KERNELS
+		if (shuffle.affine)
+			GaloisFieldNewInstructions::syndromes(reinterpret_cast<uint8_t *>(code), length, shuffle.matrices, NR, reinterpret_cast<uint8_t *>(syndromes));
+		else
+#endif
+		if (shuffle.kernel)
+			shuffle.kernel(reinterpret_cast<uint8_t *>(code), length, shuffle.tables, NR, reinterpret_cast<uint8_t *>(syndromes));
+		else
+			horner(code, syndromes, length);
+	}
+	static void compute(ValueType *code, ValueType *syndromes, int length, int stride, int columns, std::true_type)
+	{
+		static const Shuffle shuffle;
+#ifdef GFNI_KERNELS
+		if (shuffle.affine)
+			GaloisFieldNewInstructions::interleaved(reinterpret_cast<uint8_t *>(code), length, stride, columns, shuffle.matrices, NR, reinterpret_cast<uint8_t *>(syndromes));
+		else
+#endif
+		if (shuffle.interleaved)
+			shuffle.interleaved(reinterpret_cast<uint8_t *>(code), length, stride, columns, shuffle.tables, NR, reinterpret_cast<uint8_t *>(syndromes));
+		else
+			horner(code, syndromes, length, stride, columns);
+	}
+#endif
+	static void compute(ValueType *code, ValueType *syndromes, int length, std::false_type)
+	{
+		horner(code, syndromes, length);
+	}
+	static void compute(ValueType *code, ValueType *syndromes, int length, int stride, int columns, std::false_type)
+	{
+		horner(code, syndromes, length, stride, columns);
+	}
+	static int compute(ValueType *code, ValueType *syndromes, int length = N)
+	{
+#ifdef SHUFFLE_SYNDROMES
+		compute(code, syndromes, length, std::integral_constant<bool, GF::M <= 8 && sizeof(value_type) == 1>());
+#else
+		horner(code, syndromes, length);
+#endif
+		int nonzero = 0;
+		for (int i = 0; i < NR; ++i)
+			nonzero += !!syndromes[i];
+		return nonzero;
+	}
+	// returns the number of codewords with nonzero syndromes, those of codeword d start at syndromes + d*NR
+	static int compute(ValueType *code, ValueType *syndromes, int length, int stride, int columns)
+	{
+#ifdef SHUFFLE_SYNDROMES
+		compute(code, syndromes, length, stride, columns, std::integral_constant<bool, GF::M <= 8 && sizeof(value_type) == 1>());
+#else
+		horner(code, syndromes, length, stride, columns);
+#endif
+		int dirty = 0;
+		for (int d = 0; d < columns; ++d) {
+			int nonzero = 0;
+			for (int i = 0; i < NR; ++i)
+				nonzero |= !!syndromes[d*NR+i];
+			dirty += nonzero;
+		}
+		return dirty;
+	}
+};
+
+#endif
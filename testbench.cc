@@ -15,6 +15,10 @@ You should have received a copy of the CC0 Public Domain Dedication along with t
 #include "galois_field.hh"
 #include "reed_solomon.hh"
 #include "bose_chaudhuri_hocquenghem.hh"
+#include "batch_decoder.hh"
+#include "fec_stream.hh"
+#include "bit_sliced.hh"
+#include "lin_chung_han.hh"
 
 template <typename TYPE>
 void print_table(TYPE *table, const char *name, int N)
@@ -28,10 +32,51 @@ void print_table(TYPE *table, const char *name, int N)
 	std::cout << " };" << std::endl;
 }
 
-template <int NR, int FCR, int M, int P, typename TYPE>
-void test_rs(std::string name, ReedSolomon<NR, FCR, GF::Types<M, P, TYPE>> &rs, TYPE *code, TYPE *target, std::vector<uint8_t> &data)
+template <typename TYPE>
+void pack_bits(TYPE *bits, int count, uint8_t *bytes)
+{
+	for (int i = 0; i < (count + 7) / 8; ++i)
+		bytes[i] = 0;
+	for (int i = 0; i < count; ++i)
+		bytes[i/8] |= (bits[i] & 1) << (i%8);
+}
+
+template <int NR, int FCR, typename GF>
+bool syndromes_match(typename GF::value_type *code, int length)
+{
+	typedef typename GF::ValueType ValueType;
+	ValueType syndromes[NR], reference[NR];
+	Syndromes<NR, FCR, GF>::compute(reinterpret_cast<ValueType *>(code), syndromes, length);
+	Syndromes<NR, FCR, GF>::horner(reinterpret_cast<ValueType *>(code), reference, length);
+	bool match = true;
+	for (int i = 0; i < NR; ++i)
+		match &= syndromes[i] == reference[i];
+	return match;
+}
+
+void reset_decoder_stats()
+{
+#ifdef DECODER_STATS
+	DecoderCounters::instance().reset();
+#endif
+}
+
+void print_decoder_stats()
+{
+#ifdef DECODER_STATS
+	DecoderStats stats = DecoderCounters::instance().snapshot();
+	for (int i = 0; i < DecoderStats::STAGES; ++i)
+		if (stats.calls[i])
+			std::cout << "stage " << DecoderStats::name(i) << " was called " << stats.calls[i] << " times and took " << stats.ticks[i] / stats.calls[i] << " ticks per call." << std::endl;
+	std::cout << "decoder outcomes: " << stats.outcomes[DecoderStats::CLEAN] << " clean, " << stats.outcomes[DecoderStats::CORRECTED] << " corrected and " << stats.outcomes[DecoderStats::FAILED] << " failed blocks." << std::endl;
+#endif
+}
+
+template <int NR, int FCR, int M, int P, typename TYPE, int LENGTH>
+void test_rs(std::string name, ReedSolomon<NR, FCR, GF::Types<M, P, TYPE>, LENGTH> &rs, TYPE *code, TYPE *target, std::vector<uint8_t> &data)
 {
 	std::cout << "testing: " << name << std::endl;
+	reset_decoder_stats();
 
 	{
 		rs.encode(code);
@@ -55,7 +100,11 @@ void test_rs(std::string name, ReedSolomon<NR, FCR, GF::Types<M, P, TYPE>> &rs,
 		// need two parity symbols per error
 		for (int i = 0; pos < rs.N && par+2 <= NR && i < NR/2; ++i, ++corrupt, ++pos, par+=2)
 			code[pos] ^= pos;
-		int corrected = rs.decode(code, erasures, erasures_count);
+		error = !syndromes_match<NR, FCR, GF::Types<M, P, TYPE>>(code, LENGTH);
+		if (error)
+			std::cout << "syndromes error!" << std::endl;
+		assert(!error);
+		int corrected = rs.decode_fast(code, erasures, erasures_count);
 		if (corrupt != corrected)
 			std::cout << "decoder error: expected " << corrupt << " but got " << corrected << std::endl;
 		assert(corrupt == corrected);
@@ -73,7 +122,7 @@ void test_rs(std::string name, ReedSolomon<NR, FCR, GF::Types<M, P, TYPE>> &rs,
 	}
 
 	int blocks = (8 * data.size() + M * rs.K - 1) / (M * rs.K);
-	TYPE *coded = new TYPE[rs.N * blocks];
+	TYPE *coded = new TYPE[rs.N * blocks]();
 	{
 		unsigned acc = 0, bit = 0, pos = 0;
 		for (unsigned byte : data) {
@@ -81,7 +130,7 @@ void test_rs(std::string name, ReedSolomon<NR, FCR, GF::Types<M, P, TYPE>> &rs,
 			bit += 8;
 			while (bit >= M) {
 				bit -= M;
-				coded[pos++] = rs.N & acc;
+				coded[pos++] = ((1 << M) - 1) & acc;
 				acc >>= M;
 				if (pos % rs.N >= rs.K)
 					pos += NR;
@@ -89,18 +138,45 @@ void test_rs(std::string name, ReedSolomon<NR, FCR, GF::Types<M, P, TYPE>> &rs,
 		}
 	}
 	{
-		auto start = std::chrono::system_clock::now();
+		auto start = std::chrono::steady_clock::now();
 		for (int i = 0; i < blocks; ++i)
 			rs.encode(coded + i * rs.N);
-		auto end = std::chrono::system_clock::now();
-		auto msec = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-		int mbs = (data.size() + msec.count() / 2) / msec.count();
+		auto end = std::chrono::steady_clock::now();
+		auto usec = std::max(std::chrono::microseconds(1), std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+		int kbs = (1000LL * data.size() + usec.count() / 2) / usec.count();
 		int bytes = (rs.N * blocks * M) / 8;
 		float redundancy = (100.0f*(bytes-data.size())) / data.size();
-		std::cout << "encoding of " << data.size() << " random bytes into " << bytes << " codeword bytes (" << std::setprecision(1) << std::fixed << redundancy << "% redundancy) in " << blocks << " blocks took " << msec.count() << " milliseconds (" << mbs << "KB/s)." << std::endl;
+		std::cout << "encoding of " << data.size() << " random bytes into " << bytes << " codeword bytes (" << std::setprecision(1) << std::fixed << redundancy << "% redundancy) in " << blocks << " blocks took " << usec.count() << " microseconds (" << kbs << "KB/s)." << std::endl;
+	}
+	{
+		int clean = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < blocks; ++i)
+			clean += rs.check(coded + i * rs.N);
+		auto end = std::chrono::steady_clock::now();
+		auto usec = std::max(std::chrono::microseconds(1), std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+		int bytes = (rs.N * blocks * M) / 8;
+		int kbs = (1000LL * bytes + usec.count() / 2) / usec.count();
+		std::cout << "checking of " << blocks << " clean blocks by parity recomputation took " << usec.count() << " microseconds (" << kbs << "KB/s)." << std::endl;
+		if (clean != blocks)
+			std::cout << "check error: clean block reported as corrupted!" << std::endl;
+		assert(clean == blocks);
+	}
+	{
+		int dirty = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < blocks; ++i) {
+			TYPE syndromes[NR];
+			dirty += !!rs.compute_syndromes(coded + i * rs.N, syndromes);
+		}
+		auto end = std::chrono::steady_clock::now();
+		auto usec = std::max(std::chrono::microseconds(1), std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+		int bytes = (rs.N * blocks * M) / 8;
+		int kbs = (1000LL * bytes + usec.count() / 2) / usec.count();
+		std::cout << "checking of " << blocks << " clean blocks by computing syndromes took " << usec.count() << " microseconds (" << kbs << "KB/s)." << std::endl;
+		assert(!dirty);
 	}
-	std::random_device rd;
-	std::default_random_engine generator(rd());
+	std::default_random_engine generator(rs.N);
 	std::uniform_int_distribution<int> bit_dist(0, M-1), pos_dist(0, rs.N-1);
 	auto rnd_bit = std::bind(bit_dist, generator);
 	auto rnd_pos = std::bind(pos_dist, generator);
@@ -126,7 +202,7 @@ void test_rs(std::string name, ReedSolomon<NR, FCR, GF::Types<M, P, TYPE>> &rs,
 				}
 			}
 			int corrected = 0, wrong = 0;
-			auto start = std::chrono::system_clock::now();
+			auto start = std::chrono::steady_clock::now();
 			for (int i = 0; i < blocks; ++i) {
 				int result = rs.decode(tmp + i * rs.N, erasures + i * NR, erasures_count);
 				if (places > NR/2 && places > erasures_count && result >= 0)
@@ -134,11 +210,11 @@ void test_rs(std::string name, ReedSolomon<NR, FCR, GF::Types<M, P, TYPE>> &rs,
 						wrong += coded[j] != tmp[j];
 				corrected += result;
 			}
-			auto end = std::chrono::system_clock::now();
-			auto msec = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+			auto end = std::chrono::steady_clock::now();
+			auto usec = std::max(std::chrono::microseconds(1), std::chrono::duration_cast<std::chrono::microseconds>(end - start));
 			int bytes = (rs.N * blocks * M) / 8;
-			int mbs = (bytes + msec.count() / 2) / msec.count();
-			std::cout << "decoding with " << places << " errors and " << erasures_count << " known erasures per block took " << msec.count() << " milliseconds (" << mbs << "KB/s).";
+			int kbs = (1000LL * bytes + usec.count() / 2) / usec.count();
+			std::cout << "decoding with " << places << " errors and " << erasures_count << " known erasures per block took " << usec.count() << " microseconds (" << kbs << "KB/s).";
 			if (corrupt != corrected || wrong)
 				std::cout << " expected " << corrupt << " corrected errors but got " << corrected << " and " << wrong << " wrong corrections.";
 			std::cout << std::endl;
@@ -173,12 +249,14 @@ void test_rs(std::string name, ReedSolomon<NR, FCR, GF::Types<M, P, TYPE>> &rs,
 	delete[] erasures;
 	delete[] tmp;
 	delete[] coded;
+	print_decoder_stats();
 }
 
-template <int NR, int FCR, int K, int M, int P, typename TYPE>
-void test_bch(std::string name, BoseChaudhuriHocquenghem<NR, FCR, K, GF::Types<M, P, TYPE>> &bch, TYPE *code, TYPE *target, std::vector<uint8_t> &data)
+template <int NR, int FCR, int K, int M, int P, typename TYPE, int LENGTH>
+void test_bch(std::string name, BoseChaudhuriHocquenghem<NR, FCR, K, GF::Types<M, P, TYPE>, LENGTH> &bch, TYPE *code, TYPE *target, std::vector<uint8_t> &data)
 {
 	std::cout << "testing: " << name << std::endl;
+	reset_decoder_stats();
 
 	{
 		bch.encode(code);
@@ -193,6 +271,15 @@ void test_bch(std::string name, BoseChaudhuriHocquenghem<NR, FCR, K, GF::Types<M
 		if (error)
 			std::cout << "decoder error!" << std::endl;
 		assert(!error);
+		const int NP = LENGTH - K;
+		uint8_t data_bytes[(K+7)/8], parity_bytes[(NP+7)/8], target_data[(K+7)/8], target_parity[(NP+7)/8];
+		pack_bits(target, K, target_data);
+		pack_bits(target + K, NP, target_parity);
+		bch.encode_packed(target_data, parity_bytes);
+		error = !std::equal(parity_bytes, parity_bytes + (NP+7)/8, target_parity);
+		if (error)
+			std::cout << "packed encoder error!" << std::endl;
+		assert(!error);
 		int pos = 0, cap = 0, corrupt = 0, erasures_count = 0;
 		TYPE erasures[NR];
 		// need one root per erasure
@@ -201,7 +288,33 @@ void test_bch(std::string name, BoseChaudhuriHocquenghem<NR, FCR, K, GF::Types<M
 		// need two roots per error
 		for (int i = 0; pos < bch.N && cap+2 <= NR && i < NR/2; ++i, ++corrupt, ++pos, cap+=2)
 			code[pos] ^= 1;
-		int corrected = bch.decode(code, erasures, erasures_count);
+		error = !syndromes_match<NR, FCR, GF::Types<M, P, TYPE>>(code, LENGTH);
+		if (error)
+			std::cout << "syndromes error!" << std::endl;
+		assert(!error);
+		pack_bits(code, K, data_bytes);
+		pack_bits(code + K, NP, parity_bytes);
+		{
+			// the syndromes from the remainder have to agree with evaluating the whole codeword
+			typedef typename GF::Types<M, P, TYPE>::ValueType ValueType;
+			TYPE reference[NR], syndromes[NR], packed[NR];
+			Syndromes<NR, FCR, GF::Types<M, P, TYPE>>::horner(reinterpret_cast<ValueType *>(code), reinterpret_cast<ValueType *>(reference), LENGTH);
+			bch.compute_syndromes(code, syndromes);
+			bch.compute_syndromes_packed(data_bytes, parity_bytes, packed);
+			error = !std::equal(reference, reference + NR, syndromes) || !std::equal(reference, reference + NR, packed);
+			if (error)
+				std::cout << "remainder syndromes error!" << std::endl;
+			assert(!error);
+		}
+		int corrected = bch.decode_packed(data_bytes, parity_bytes, erasures, erasures_count);
+		if (corrupt != corrected)
+			std::cout << "packed decoder error: expected " << corrupt << " but got " << corrected << std::endl;
+		assert(corrupt == corrected);
+		error = !std::equal(data_bytes, data_bytes + (K+7)/8, target_data) || !std::equal(parity_bytes, parity_bytes + (NP+7)/8, target_parity);
+		if (error)
+			std::cout << "packed decoder error: code doesnt match target" << std::endl;
+		assert(!error);
+		corrected = bch.decode_fast(code, erasures, erasures_count);
 		if (corrupt != corrected)
 			std::cout << "decoder error: expected " << corrupt << " but got " << corrected << std::endl;
 		assert(corrupt == corrected);
@@ -218,7 +331,7 @@ void test_bch(std::string name, BoseChaudhuriHocquenghem<NR, FCR, K, GF::Types<M
 		assert(!error);
 	}
 	int blocks = (8 * data.size() + K - 1) / K;
-	TYPE *coded = new TYPE[bch.N * blocks];
+	TYPE *coded = new TYPE[bch.N * blocks]();
 	{
 		unsigned pos = 0;
 		for (unsigned byte : data) {
@@ -230,18 +343,59 @@ void test_bch(std::string name, BoseChaudhuriHocquenghem<NR, FCR, K, GF::Types<M
 		}
 	}
 	{
-		auto start = std::chrono::system_clock::now();
+		auto start = std::chrono::steady_clock::now();
 		for (int i = 0; i < blocks; ++i)
 			bch.encode(coded + i * bch.N);
-		auto end = std::chrono::system_clock::now();
-		auto msec = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-		int mbs = (data.size() + msec.count() / 2) / msec.count();
+		auto end = std::chrono::steady_clock::now();
+		auto usec = std::max(std::chrono::microseconds(1), std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+		int kbs = (1000LL * data.size() + usec.count() / 2) / usec.count();
 		int bytes = (bch.N * blocks) / 8;
 		float redundancy = (100.0f*(bytes-data.size())) / data.size();
-		std::cout << "encoding of " << data.size() << " random bytes into " << bytes << " codeword bytes (" << std::setprecision(1) << std::fixed << redundancy << "% redundancy) in " << blocks << " blocks took " << msec.count() << " milliseconds (" << mbs << "KB/s)." << std::endl;
+		std::cout << "encoding of " << data.size() << " random bytes into " << bytes << " codeword bytes (" << std::setprecision(1) << std::fixed << redundancy << "% redundancy) in " << blocks << " blocks took " << usec.count() << " microseconds (" << kbs << "KB/s)." << std::endl;
 	}
-	std::random_device rd;
-	std::default_random_engine generator(rd());
+	{
+		int data_bytes = (K + 7) / 8, parity_bytes = (bch.NP + 7) / 8;
+		int packed_blocks = data.size() / data_bytes;
+		uint8_t *parity = new uint8_t[parity_bytes * packed_blocks];
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < packed_blocks; ++i)
+			bch.encode_packed(data.data() + i * data_bytes, parity + i * parity_bytes);
+		auto end = std::chrono::steady_clock::now();
+		auto usec = std::max(std::chrono::microseconds(1), std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+		int bytes = packed_blocks * data_bytes;
+		int kbs = (1000LL * bytes + usec.count() / 2) / usec.count();
+		std::cout << "packed encoding of " << bytes << " bytes in " << packed_blocks << " blocks took " << usec.count() << " microseconds (" << kbs << "KB/s)." << std::endl;
+		delete[] parity;
+	}
+	{
+		int clean = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < blocks; ++i)
+			clean += bch.check(coded + i * bch.N);
+		auto end = std::chrono::steady_clock::now();
+		auto usec = std::max(std::chrono::microseconds(1), std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+		int bytes = (bch.N * blocks) / 8;
+		int kbs = (1000LL * bytes + usec.count() / 2) / usec.count();
+		std::cout << "checking of " << blocks << " clean blocks by parity recomputation took " << usec.count() << " microseconds (" << kbs << "KB/s)." << std::endl;
+		if (clean != blocks)
+			std::cout << "check error: clean block reported as corrupted!" << std::endl;
+		assert(clean == blocks);
+	}
+	{
+		int dirty = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < blocks; ++i) {
+			TYPE syndromes[NR];
+			dirty += !!bch.compute_syndromes(coded + i * bch.N, syndromes);
+		}
+		auto end = std::chrono::steady_clock::now();
+		auto usec = std::max(std::chrono::microseconds(1), std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+		int bytes = (bch.N * blocks) / 8;
+		int kbs = (1000LL * bytes + usec.count() / 2) / usec.count();
+		std::cout << "checking of " << blocks << " clean blocks by computing syndromes took " << usec.count() << " microseconds (" << kbs << "KB/s)." << std::endl;
+		assert(!dirty);
+	}
+	std::default_random_engine generator(bch.N);
 	std::uniform_int_distribution<int> pos_dist(0, bch.N-1);
 	auto rnd_pos = std::bind(pos_dist, generator);
 	std::vector<uint8_t> recovered(data.size());
@@ -266,7 +420,7 @@ void test_bch(std::string name, BoseChaudhuriHocquenghem<NR, FCR, K, GF::Types<M
 				}
 			}
 			int corrected = 0, wrong = 0;
-			auto start = std::chrono::system_clock::now();
+			auto start = std::chrono::steady_clock::now();
 			for (int i = 0; i < blocks; ++i) {
 				int result = bch.decode(tmp + i * bch.N, erasures + i * NR, erasures_count);
 				if (places > NR/2 && places > erasures_count && result >= 0)
@@ -274,11 +428,11 @@ void test_bch(std::string name, BoseChaudhuriHocquenghem<NR, FCR, K, GF::Types<M
 						wrong += coded[j] != tmp[j];
 				corrected += result;
 			}
-			auto end = std::chrono::system_clock::now();
-			auto msec = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+			auto end = std::chrono::steady_clock::now();
+			auto usec = std::max(std::chrono::microseconds(1), std::chrono::duration_cast<std::chrono::microseconds>(end - start));
 			int bytes = (bch.N * blocks) / 8;
-			int mbs = (bytes + msec.count() / 2) / msec.count();
-			std::cout << "decoding with " << places << " errors and " << erasures_count << " known erasures per block took " << msec.count() << " milliseconds (" << mbs << "KB/s).";
+			int kbs = (1000LL * bytes + usec.count() / 2) / usec.count();
+			std::cout << "decoding with " << places << " errors and " << erasures_count << " known erasures per block took " << usec.count() << " microseconds (" << kbs << "KB/s).";
 			if (corrupt != corrected || wrong)
 				std::cout << " expected " << corrupt << " corrected errors but got " << corrected << " and " << wrong << " wrong corrections.";
 			std::cout << std::endl;
@@ -317,12 +471,811 @@ void test_bch(std::string name, BoseChaudhuriHocquenghem<NR, FCR, K, GF::Types<M
 	delete[] erasures;
 	delete[] tmp;
 	delete[] coded;
+	print_decoder_stats();
+}
+
+template <int DEPTH, typename CODEC>
+void test_stream(std::string name, CODEC &codec, std::vector<uint8_t> &data)
+{
+	std::cout << "testing: " << name << std::endl;
+	typedef FecStream<CODEC, DEPTH> Stream;
+	Stream stream(codec);
+	int frames = (data.size() + Stream::PAYLOAD - 1) / Stream::PAYLOAD;
+	uint8_t *coded = new uint8_t[Stream::FRAME * frames];
+	std::default_random_engine generator(frames);
+	{
+		// feed the stream in chunks of random size
+		std::uniform_int_distribution<int> distribution(1, 3 * Stream::PAYLOAD);
+		int done = 0;
+		for (size_t pos = 0; pos < data.size();) {
+			int count = std::min<size_t>(distribution(generator), data.size() - pos);
+			done += stream.write(data.data() + pos, count, coded + done * Stream::FRAME);
+			pos += count;
+		}
+		done += stream.flush(coded + done * Stream::FRAME);
+		bool error = done != frames || stream.pending();
+		for (size_t i = 0; i < data.size(); ++i)
+			error |= coded[(i / Stream::PAYLOAD) * Stream::FRAME + i % Stream::PAYLOAD] != data[i];
+		if (error)
+			std::cout << "stream payload error!" << std::endl;
+		assert(!error);
+		uint8_t code[CODEC::N];
+		for (int f = 0; f < frames && !error; ++f) {
+			for (int d = 0; d < DEPTH; ++d) {
+				for (int i = 0; i < CODEC::N; ++i)
+					code[i] = coded[f * Stream::FRAME + i * DEPTH + d];
+				error |= !codec.check(code);
+			}
+		}
+		if (error)
+			std::cout << "stream encoder error!" << std::endl;
+		assert(!error);
+	}
+	{
+		// a burst of DEPTH*T bytes in every frame leaves T errors in each codeword
+		const int T = Stream::NR / 2, BURST = DEPTH * T;
+		std::vector<uint8_t> orig(coded, coded + Stream::FRAME * frames);
+		std::uniform_int_distribution<int> offset(0, Stream::FRAME - BURST);
+		std::uniform_int_distribution<int> noise(1, 255);
+		for (int f = 0; f < frames; ++f) {
+			int pos = f * Stream::FRAME + offset(generator);
+			for (int i = 0; i < BURST; ++i)
+				coded[pos + i] ^= noise(generator);
+		}
+		auto start = std::chrono::steady_clock::now();
+		int corrected = stream.decode(coded, frames);
+		auto end = std::chrono::steady_clock::now();
+		auto usec = std::max(std::chrono::microseconds(1), std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+		int kbs = (1000LL * data.size() + usec.count() / 2) / usec.count();
+		bool error = corrected != BURST * frames;
+		for (int i = 0; i < Stream::FRAME * frames; ++i)
+			error |= coded[i] != orig[i];
+		if (error)
+			std::cout << "stream decoder error!" << std::endl;
+		assert(!error);
+		std::cout << "stream decoding of " << frames << " frames with a burst of " << BURST << " bytes each took " << usec.count() << " microseconds (" << kbs << "KB/s)." << std::endl;
+	}
+	delete[] coded;
+}
+
+template <int NR, int FCR, typename GF, template <int, typename> class SOLVER>
+void benchmark_solver(std::string name, typename GF::ValueType *syndromes, typename GF::IndexType *positions, typename GF::ValueType *values, int *counts, int *erasures_counts, int blocks)
+{
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	bool error = false;
+	for (int b = 0; b < blocks; ++b) {
+		IndexType locations[NR];
+		ValueType magnitudes[NR];
+		int count = Correction<NR, FCR, GF, SOLVER>::algorithm(syndromes + b * NR, locations, magnitudes, positions + b * NR, erasures_counts[b]);
+		error |= count != counts[b];
+		for (int i = 0; i < count && !error; ++i) {
+			int j = 0;
+			while (j < count && (int)positions[b*NR+j] != (int)locations[i])
+				++j;
+			error |= j == count || values[b*NR+j] != magnitudes[i];
+		}
+	}
+	if (error)
+		std::cout << name << " solver error!" << std::endl;
+	assert(!error);
+	// erasure locators are prepared upfront, so only the key equation and the evaluator are measured
+	std::vector<ValueType> locators((NR+1) * blocks);
+	for (int b = 0; b < blocks; ++b) {
+		ValueType *locator = locators.data() + b * (NR+1);
+		locator[0] = ValueType(1);
+		for (int i = 1; i <= NR; ++i)
+			locator[i] = ValueType(0);
+		for (int i = 0; i < erasures_counts[b]; ++i) {
+			IndexType tmp(IndexType(GF::N-1) / positions[b*NR+i]);
+			for (int j = i; j >= 0; --j)
+				locator[j+1] += tmp * locator[j];
+		}
+	}
+	int checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int b = 0; b < blocks; ++b) {
+		ValueType locator[NR+1], evaluator[NR];
+		for (int i = 0; i <= NR; ++i)
+			locator[i] = locators[b*(NR+1)+i];
+		int degree = SOLVER<NR, GF>::algorithm(syndromes + b * NR, locator, erasures_counts[b], evaluator);
+		if (!SOLVER<NR, GF>::EVALUATOR)
+			Forney<NR, FCR, GF>::compute_evaluator(syndromes + b * NR, locator, degree, evaluator);
+		checksum += degree + (int)evaluator[0];
+	}
+	auto end = std::chrono::steady_clock::now();
+	auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+	std::cout << name << " key equation of " << blocks << " blocks took " << nsec.count() / blocks << " nanoseconds per block (checksum " << checksum << ")." << std::endl;
+}
+
+template <int NR, int FCR, typename GF>
+void test_solvers(std::string name, bool binary)
+{
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	std::cout << "testing: " << name << " key equation solvers" << std::endl;
+	const int blocks = 20000;
+	ValueType *syndromes = new ValueType[NR * blocks];
+	IndexType *positions = new IndexType[NR * blocks];
+	ValueType *values = new ValueType[NR * blocks];
+	int *counts = new int[blocks], *erasures_counts = new int[blocks];
+	std::default_random_engine generator(NR);
+	std::uniform_int_distribution<int> distribution(0, GF::N-1);
+	for (int b = 0; b < blocks; ++b) {
+		// binary codes have no erasures, others use up all parity with errors and erasures
+		int erasures_count = binary ? 0 : distribution(generator) % (NR+1);
+		int count = erasures_count + (NR - erasures_count) / 2;
+		for (int i = 0; i < count; ++i) {
+			int pos;
+			for (bool again = true; again;) {
+				pos = distribution(generator);
+				again = false;
+				for (int j = 0; j < i; ++j)
+					again |= (int)positions[b*NR+j] == pos;
+			}
+			positions[b*NR+i] = IndexType(pos);
+			values[b*NR+i] = binary ? ValueType(1) : ValueType(1 + distribution(generator));
+		}
+		// $syndromes_j = \sum_i values_i * pe^{(FCR+j)(N-1-positions_i)}$
+		for (int j = 0; j < NR; ++j) {
+			ValueType sum(0);
+			for (int i = 0; i < count; ++i)
+				sum += values[b*NR+i] * IndexType((long long)(FCR + j) * (GF::N - 1 - (int)positions[b*NR+i]) % GF::N);
+			syndromes[b*NR+j] = sum;
+		}
+		counts[b] = count;
+		erasures_counts[b] = erasures_count;
+	}
+	benchmark_solver<NR, FCR, GF, BerlekampMassey>("BerlekampMassey", syndromes, positions, values, counts, erasures_counts, blocks);
+	benchmark_solver<NR, FCR, GF, InversionlessBerlekampMassey>("InversionlessBerlekampMassey", syndromes, positions, values, counts, erasures_counts, blocks);
+	benchmark_solver<NR, FCR, GF, Euclidean>("Euclidean", syndromes, positions, values, counts, erasures_counts, blocks);
+	delete[] syndromes;
+	delete[] positions;
+	delete[] values;
+	delete[] counts;
+	delete[] erasures_counts;
+}
+
+template <typename CODEC>
+void test_latency(std::string name, CODEC &codec, int K, int T, int symbol_max)
+{
+	typedef typename CODEC::value_type TYPE;
+	const int N = CODEC::N;
+	std::cout << "latency: " << name << std::endl;
+	const int samples = std::max(100, std::min(2000, (1 << 22) / N));
+	std::default_random_engine generator(N);
+	std::uniform_int_distribution<int> symbol(0, symbol_max), noise(1, symbol_max), position(0, N-1);
+	TYPE *code = new TYPE[N], *orig = new TYPE[N];
+	int *positions = new int[T];
+	std::vector<long long> latencies(samples);
+	for (int mode = 0; mode < 2; ++mode) {
+		for (int errors: { 0, T / 2, T }) {
+			bool error = false;
+			for (int s = 0; s < samples; ++s) {
+				for (int i = 0; i < K; ++i)
+					orig[i] = symbol(generator);
+				codec.encode(orig);
+				for (int i = 0; i < N; ++i)
+					code[i] = orig[i];
+				for (int i = 0; i < errors; ++i) {
+					for (bool again = true; again;) {
+						positions[i] = position(generator);
+						again = false;
+						for (int j = 0; j < i; ++j)
+							again |= positions[j] == positions[i];
+					}
+					code[positions[i]] ^= noise(generator);
+				}
+				auto start = std::chrono::steady_clock::now();
+				int corrected = mode ? codec.decode_constant_time(code) : codec.decode(code);
+				auto end = std::chrono::steady_clock::now();
+				latencies[s] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+				error |= corrected != errors;
+				for (int i = 0; i < N; ++i)
+					error |= code[i] != orig[i];
+			}
+			if (error)
+				std::cout << "latency decoder error!" << std::endl;
+			assert(!error);
+			std::sort(latencies.begin(), latencies.end());
+			std::cout << (mode ? "constant time" : "regular") << " decoding with " << errors << " errors per block: p50 " << latencies[samples/2] << " p99 " << latencies[samples*99/100] << " max " << latencies.back() << " nanoseconds." << std::endl;
+		}
+	}
+	delete[] code;
+	delete[] orig;
+	delete[] positions;
+}
+
+template <typename GF>
+void test_field(std::string name)
+{
+	// the reduction modulo N of index products and quotients, checked against plain integer arithmetic and timed
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	const int N = GF::N, step = GF::M > 8 ? 97 : 1;
+	bool error = false;
+	for (int a = 0; a < N; a += step) {
+		for (int b = 0; b < N; b += step) {
+			error |= (int)(IndexType(a) * IndexType(b)) != (a + b) % N;
+			error |= (int)(IndexType(a) / IndexType(b)) != (a - b + N) % N;
+		}
+	}
+	if (error)
+		std::cout << "field arithmetic " << name << " error!" << std::endl;
+	assert(!error);
+	const int count = 1 << 24;
+	std::default_random_engine generator(N);
+	std::uniform_int_distribution<int> distribution(1, N - 1);
+	std::vector<IndexType> indices(256);
+	std::vector<ValueType> values(256);
+	for (int i = 0; i < 256; ++i) {
+		indices[i] = IndexType(distribution(generator));
+		values[i] = ValueType(distribution(generator));
+	}
+	IndexType index(1);
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; ++i)
+		index = index * indices[i & 255] / indices[(i >> 8) & 255];
+	auto middle = std::chrono::steady_clock::now();
+	ValueType value(1);
+	for (int i = 0; i < count; ++i)
+		value = fma(indices[i & 255], value, values[(i >> 8) & 255]) * values[i & 255];
+	auto end = std::chrono::steady_clock::now();
+	double indexed = std::chrono::duration_cast<std::chrono::nanoseconds>(middle - start).count() / (2.0 * count);
+	double valued = std::chrono::duration_cast<std::chrono::nanoseconds>(end - middle).count() / (2.0 * count);
+	std::cout << "field arithmetic of " << name << ": index products and quotients took " << indexed << " nanoseconds, value products and fma " << valued << " nanoseconds (checksum " << (int)index + (int)value << ")." << std::endl;
+}
+
+template <typename CODEC>
+void test_batch(std::string name, CODEC &codec, int K, int T, int symbol_max)
+{
+	typedef typename CODEC::value_type TYPE;
+	const int N = CODEC::N, NR = 2 * T;
+	const int blocks = std::max(16, std::min(1024, (1 << 22) / N));
+	// at least three threads, so blocks get stolen even on small machines
+	ThreadPool pool(std::max(3, (int)std::thread::hardware_concurrency()));
+	BatchDecoder<CODEC> batch(codec, pool);
+	std::default_random_engine generator(N);
+	std::uniform_int_distribution<int> symbol(0, symbol_max), noise(1, symbol_max), position(0, N-1), places(0, T + 2);
+	std::vector<TYPE> orig(N), serial(N * blocks), parallel(N * blocks), erasures(NR * blocks);
+	std::vector<int> erasures_counts(blocks), expected(blocks), results(blocks), positions(T + 2);
+	for (int b = 0; b < blocks; ++b) {
+		for (int i = 0; i < K; ++i)
+			orig[i] = symbol(generator);
+		codec.encode(orig.data());
+		TYPE *code = serial.data() + b * N;
+		std::copy(orig.begin(), orig.end(), code);
+		// up to two errors beyond capacity, the first ones of every other block are known erasures
+		int errors = places(generator);
+		for (int i = 0; i < errors; ++i) {
+			for (bool again = true; again;) {
+				positions[i] = position(generator);
+				again = false;
+				for (int j = 0; j < i; ++j)
+					again |= positions[j] == positions[i];
+			}
+			code[positions[i]] ^= noise(generator);
+		}
+		erasures_counts[b] = b % 2 ? std::min(errors, T) : 0;
+		for (int i = 0; i < erasures_counts[b]; ++i)
+			erasures[b * NR + i] = positions[i];
+	}
+	parallel = serial;
+	bool error = false;
+	auto start = std::chrono::steady_clock::now();
+	for (int b = 0; b < blocks; ++b)
+		expected[b] = codec.decode(serial.data() + b * N, erasures_counts[b] ? erasures.data() + b * NR : 0, erasures_counts[b]);
+	auto middle = std::chrono::steady_clock::now();
+	batch.decode(parallel.data(), results.data(), blocks, erasures.data(), erasures_counts.data(), NR);
+	auto end = std::chrono::steady_clock::now();
+	error |= results != expected || parallel != serial;
+	// same number of erasures for every block, none here
+	std::vector<TYPE> again(parallel);
+	batch.decode(again.data(), results.data(), blocks, erasures.data(), 0, NR);
+	for (int b = 0; b < blocks; ++b)
+		error |= results[b] != (expected[b] < 0 ? codec.decode(parallel.data() + b * N) : 0);
+	error |= again != parallel;
+	if (error)
+		std::cout << "batch decoder " << name << " error!" << std::endl;
+	assert(!error);
+	long long took = std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count();
+	long long alone = std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count();
+	std::cout << "batch decoding of " << blocks << " blocks on " << pool.threads_count() << " threads took " << took << " microseconds instead of " << alone << "." << std::endl;
+}
+
+template <typename CODEC>
+void test_constant_time(std::string name, CODEC &codec, int K, int T, int symbol_max)
+{
+	typedef typename CODEC::value_type TYPE;
+	const int N = CODEC::N;
+	const int samples = std::max(20, std::min(1000, (1 << 20) / N));
+	std::default_random_engine generator(N);
+	std::uniform_int_distribution<int> symbol(0, symbol_max), noise(1, symbol_max), position(0, N-1);
+	std::vector<TYPE> orig(N), received(N), regular(N), constant(N), erasures(2 * T);
+	std::vector<int> positions(2 * T + 2);
+	// erasures and errors per block, the last three are beyond what the code can take
+	const int cases[6][2] = { { T, T / 2 }, { 2 * T, 0 }, { 1, T - 1 }, { 0, T + 1 }, { T, T / 2 + 1 }, { 2 * T - 1, 1 } };
+	bool error = false;
+	for (auto c: cases) {
+		int erasures_count = c[0], errors = c[1], failed = 0;
+		for (int s = 0; s < samples; ++s) {
+			for (int i = 0; i < K; ++i)
+				orig[i] = symbol(generator);
+			codec.encode(orig.data());
+			received = orig;
+			for (int i = 0; i < erasures_count + errors; ++i) {
+				for (bool again = true; again;) {
+					positions[i] = position(generator);
+					again = false;
+					for (int j = 0; j < i; ++j)
+						again |= positions[j] == positions[i];
+				}
+				if (i < erasures_count) {
+					erasures[i] = positions[i];
+					received[positions[i]] = symbol(generator);
+				} else {
+					received[positions[i]] ^= noise(generator);
+				}
+			}
+			regular = received;
+			constant = received;
+			int expected = codec.decode(regular.data(), erasures.data(), erasures_count);
+			int result = codec.decode_constant_time(constant.data(), erasures.data(), erasures_count);
+			error |= result != expected;
+			// a failed decode must leave the codeword untouched
+			error |= constant != (result < 0 ? received : regular);
+			if (erasures_count + 2 * errors <= 2 * T)
+				error |= constant != orig;
+			failed += result < 0;
+		}
+		std::cout << "constant time decoding with " << erasures_count << " erasures and " << errors << " errors failed on " << failed << " of " << samples << " blocks." << std::endl;
+	}
+	if (error)
+		std::cout << "constant time decoder " << name << " error!" << std::endl;
+	assert(!error);
+}
+
+template <typename CODEC>
+void test_parallel(std::string name, CODEC &codec, int K, int T, int symbol_max)
+{
+	typedef typename CODEC::value_type TYPE;
+	const int N = CODEC::N;
+	// at least three threads, so the ranges get split even on small machines
+	ThreadPool pool(std::max(3, (int)std::thread::hardware_concurrency()));
+	std::cout << "parallel: " << name << " with " << pool.threads_count() << " threads" << std::endl;
+	std::default_random_engine generator(N);
+	std::uniform_int_distribution<int> symbol(0, symbol_max), noise(1, symbol_max), position(0, N-1);
+	std::vector<TYPE> orig(N), code(N), copy(N);
+	std::vector<int> positions(T);
+	for (int errors: { 0, T / 2, T }) {
+		bool error = false;
+		long long serial = 0, parallel = 0;
+		for (int s = 0; s < 4; ++s) {
+			for (int i = 0; i < K; ++i)
+				orig[i] = symbol(generator);
+			codec.encode(orig.data());
+			code = orig;
+			for (int i = 0; i < errors; ++i) {
+				for (bool again = true; again;) {
+					positions[i] = position(generator);
+					again = false;
+					for (int j = 0; j < i; ++j)
+						again |= positions[j] == positions[i];
+				}
+				code[positions[i]] ^= noise(generator);
+			}
+			copy = code;
+			// a nested run in a task of the same pool is done inline
+			std::vector<TYPE> nested(code);
+			nested.insert(nested.end(), code.begin(), code.end());
+			int results[2];
+			pool.run(2, [&](int i) {
+				results[i] = codec.decode_parallel(nested.data() + i * N, pool);
+			});
+			error |= results[0] != errors || results[1] != errors;
+			error |= !std::equal(orig.begin(), orig.end(), nested.begin()) || !std::equal(orig.begin(), orig.end(), nested.begin() + N);
+			// there are no more syndromes than parity symbols
+			std::vector<TYPE> syndromes(N - K), reference(N - K);
+			codec.compute_syndromes(code.data(), reference.data());
+			codec.compute_syndromes_parallel(code.data(), syndromes.data(), pool);
+			error |= syndromes != reference;
+			auto start = std::chrono::steady_clock::now();
+			error |= codec.decode(copy.data()) != errors;
+			auto middle = std::chrono::steady_clock::now();
+			error |= codec.decode_parallel(code.data(), pool) != errors;
+			auto end = std::chrono::steady_clock::now();
+			serial += std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count();
+			parallel += std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count();
+			error |= code != orig || copy != orig;
+		}
+		if (error)
+			std::cout << "parallel decoder error!" << std::endl;
+		assert(!error);
+		std::cout << "parallel decoding with " << errors << " errors per block took " << parallel / 4 << " microseconds instead of " << serial / 4 << "." << std::endl;
+		// waking the threads may cost a little, when there are fewer cores than threads the ranges also take turns
+		bool oversubscribed = pool.threads_count() > (int)std::thread::hardware_concurrency();
+		bool slower = parallel / 4 > serial / 4 + (oversubscribed ? serial / 16 : 0) + 100;
+		if (slower)
+			std::cout << "parallel decoding slower than serial decoding error!" << std::endl;
+		assert(!slower);
+	}
+}
+
+template <int M, int POLY, typename TYPE>
+void test_arithmetic(std::string name)
+{
+	// carry-less products have to agree with the tables
+	typedef GF::Types<M, POLY, TYPE> Table;
+	typedef GF::Types<M, POLY, TYPE, GF::CarrylessArithmetic> Carryless;
+	bool error = false;
+	for (int a = 0; a < Table::Q; a += M > 8 ? 7 : 1) {
+		for (int b = 0; b < Table::Q; b += M > 8 ? 13 : 1) {
+			error |= (int)(typename Table::ValueType(a) * typename Table::ValueType(b)) != (int)(typename Carryless::ValueType(a) * typename Carryless::ValueType(b));
+			if (a < Table::N)
+				error |= (int)(typename Table::IndexType(a) * typename Table::ValueType(b)) != (int)(typename Carryless::IndexType(a) * typename Carryless::ValueType(b));
+		}
+	}
+	// $x^2 + x = xxx$ has to be solved for every xxx it can reach, the all ones value included
+	for (int x = 2; x < Table::Q; ++x) {
+		typename Table::ValueType v(x), r(Artin_Schreier_imap(v * v + v));
+		error |= r * r + r != v * v + v;
+	}
+	if (error)
+		std::cout << "arithmetic error for " << name << "!" << std::endl;
+	assert(!error);
+}
+
+template <typename CODEC, typename SLICED>
+void test_bit_sliced(std::string name, CODEC &codec, SLICED &sliced, int symbol_max)
+{
+	typedef typename CODEC::value_type TYPE;
+	const int N = CODEC::N, K = CODEC::K, NR = N - K;
+	// not a multiple of the lanes, so the last group is only partially filled
+	const int BLOCKS = 3 * SLICED::LANES + 5;
+	std::default_random_engine generator(N);
+	std::uniform_int_distribution<int> symbol(0, symbol_max), noise(1, symbol_max), position(0, N-1);
+	std::vector<TYPE> codes(BLOCKS * N), reference;
+	for (int i = 0; i < BLOCKS * N; ++i)
+		codes[i] = symbol(generator);
+	reference = codes;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < BLOCKS; ++i)
+		codec.encode(reference.data() + i * N);
+	auto middle = std::chrono::steady_clock::now();
+	sliced.encode(codes.data(), BLOCKS);
+	auto end = std::chrono::steady_clock::now();
+	bool error = codes != reference;
+	std::cout << "bit sliced encoding of " << BLOCKS << " blocks took " << std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count() << " microseconds instead of " << std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count() << "." << std::endl;
+	int dirty = 0;
+	for (int i = 0; i < BLOCKS; i += 3, ++dirty)
+		codes[i*N+position(generator)] ^= noise(generator);
+	std::vector<TYPE> syndromes(BLOCKS * NR), expected(BLOCKS * NR);
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < BLOCKS; ++i)
+		codec.compute_syndromes(codes.data() + i * N, expected.data() + i * NR);
+	middle = std::chrono::steady_clock::now();
+	error |= sliced.compute_syndromes(codes.data(), syndromes.data(), BLOCKS) != dirty;
+	end = std::chrono::steady_clock::now();
+	error |= syndromes != expected;
+	std::cout << "bit sliced syndromes of " << BLOCKS << " blocks took " << std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count() << " microseconds instead of " << std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count() << "." << std::endl;
+	if (error)
+		std::cout << "bit sliced " << name << " error!" << std::endl;
+	assert(!error);
+}
+
+template <typename CODEC>
+void test_erasures(std::string name, CODEC &codec, int K, int symbol_max)
+{
+	typedef typename CODEC::value_type TYPE;
+	const int N = CODEC::N, NR = N - K;
+	std::default_random_engine generator(N);
+	std::uniform_int_distribution<int> symbol(0, symbol_max), noise(1, symbol_max), position(0, N-1);
+	std::vector<TYPE> orig(N), code(N);
+	std::vector<TYPE> erasures(NR);
+	bool error = false;
+	long long took = 0;
+	for (int s = 0; s < 100; ++s) {
+		for (int i = 0; i < K; ++i)
+			orig[i] = symbol(generator);
+		codec.encode(orig.data());
+		code = orig;
+		// every parity symbol spent on an erasure, every other one is left intact
+		int erasures_count = NR - s % 2 * 2, corrupt = 0;
+		for (int i = 0; i < erasures_count; ++i) {
+			for (bool again = true; again;) {
+				erasures[i] = position(generator);
+				again = false;
+				for (int j = 0; j < i; ++j)
+					again |= erasures[j] == erasures[i];
+			}
+			if (i % 2) {
+				code[erasures[i]] ^= noise(generator);
+				++corrupt;
+			}
+		}
+		// leaves room for one error the erasures do not know about
+		if (erasures_count < NR) {
+			int pos;
+			for (bool again = true; again;) {
+				pos = position(generator);
+				again = false;
+				for (int j = 0; j < erasures_count; ++j)
+					again |= erasures[j] == pos;
+			}
+			code[pos] ^= noise(generator);
+			++corrupt;
+		}
+		auto start = std::chrono::steady_clock::now();
+		error |= codec.decode(code.data(), erasures.data(), erasures_count) != corrupt;
+		auto end = std::chrono::steady_clock::now();
+		took += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		error |= code != orig;
+	}
+	if (error)
+		std::cout << "erasures " << name << " error!" << std::endl;
+	assert(!error);
+	std::cout << "decoding with up to " << NR << " erasures took " << took / 100 << " nanoseconds per block." << std::endl;
+}
+
+template <typename GF>
+void test_lin_chung_han(std::string name, int data_count, int parity_count, int length)
+{
+	typedef typename GF::value_type TYPE;
+	std::cout << "testing: " << name << " with " << data_count << " data and " << parity_count << " parity shards of " << length << " symbols" << std::endl;
+	static LinChungHan<GF> codec;
+	std::default_random_engine generator(data_count + parity_count);
+	std::uniform_int_distribution<int> symbol(0, GF::N);
+	int shards_count = data_count + parity_count;
+	std::vector<TYPE> shards(shards_count * length), orig;
+	std::vector<TYPE *> data(data_count), parity(parity_count);
+	for (int i = 0; i < data_count; ++i)
+		data[i] = shards.data() + i * length;
+	for (int i = 0; i < parity_count; ++i)
+		parity[i] = shards.data() + (data_count + i) * length;
+	for (int i = 0; i < data_count * length; ++i)
+		shards[i] = symbol(generator);
+	auto start = std::chrono::steady_clock::now();
+	codec.encode(data.data(), data_count, parity.data(), parity_count, length);
+	auto end = std::chrono::steady_clock::now();
+	std::cout << "encoding took " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " microseconds." << std::endl;
+	orig = shards;
+	std::vector<int> erasures(shards_count);
+	for (int i = 0; i < shards_count; ++i)
+		erasures[i] = i;
+	bool error = false;
+	for (int erasures_count: { 1, parity_count / 2, parity_count }) {
+		// any erasures_count of the shards, data or parity
+		std::shuffle(erasures.begin(), erasures.end(), generator);
+		for (int i = 0; i < erasures_count; ++i)
+			for (int j = 0; j < length; ++j)
+				shards[erasures[i]*length+j] = symbol(generator);
+		start = std::chrono::steady_clock::now();
+		error |= codec.decode(data.data(), data_count, parity.data(), parity_count, length, erasures.data(), erasures_count) != erasures_count;
+		end = std::chrono::steady_clock::now();
+		error |= shards != orig;
+		std::cout << "recovering " << erasures_count << " shards took " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " microseconds." << std::endl;
+	}
+	// one parity shard per erasure
+	error |= codec.decode(data.data(), data_count, parity.data(), parity_count, length, erasures.data(), parity_count + 1) != -1;
+	if (error)
+		std::cout << "additive FFT erasure codec error!" << std::endl;
+	assert(!error);
+}
+
+template <int NR, int FCR, typename GF, int LENGTH>
+void test_affine(std::string name, ReedSolomon<NR, FCR, GF, LENGTH> &rs)
+{
+	typedef typename GF::ValueType ValueType;
+	typedef typename GF::IndexType IndexType;
+	typedef ReedSolomon<NR, FCR, GF, LENGTH> CODEC;
+	const int N = CODEC::N, K = CODEC::K, SHORTENED = CODEC::SHORTENED;
+	// the isomorphism to the AES field and the bit matrices have to agree with the tables
+	const GaloisFieldAffine<GF> &field = GaloisFieldAffine<GF>::instance();
+	bool error = false;
+	for (int a = 0; a < GF::Q; ++a) {
+		uint64_t matrix = GaloisFieldAffine<GF>::matrix(ValueType(a));
+		for (int b = 0; b < GF::Q; ++b) {
+			int product = (int)(ValueType(a) * ValueType(b));
+			error |= field.mul(a, b) != product;
+			error |= GaloisFieldNewInstructions::affine(matrix, b) != product;
+		}
+		error |= GaloisFieldNewInstructions::affine(field.from_aes_matrix, GaloisFieldNewInstructions::affine(field.to_aes_matrix, a)) != a;
+	}
+#ifdef GFNI_KERNELS
+	std::cout << "GFNI " << (GaloisFieldNewInstructions::supported() ? "enabled" : "not supported") << " for " << name << std::endl;
+#endif
+	// locators with distinct roots at the positions of the code, dispatched and portable Chien search have to agree
+	const int LOOPS = 10000;
+	std::default_random_engine generator(N);
+	std::uniform_int_distribution<int> symbol(0, GF::N), position(SHORTENED, GF::N-1);
+	std::vector<ValueType> locators(LOOPS * (NR+1));
+	std::vector<int> degrees(LOOPS);
+	for (int loop = 0; loop < LOOPS; ++loop) {
+		ValueType *locator = locators.data() + loop * (NR+1);
+		int degree = 1 + loop % NR;
+		degrees[loop] = degree;
+		locator[0] = ValueType(1);
+		IndexType roots[NR];
+		for (int i = 0; i < degree; ++i) {
+			bool unique;
+			do {
+				roots[i] = IndexType(position(generator));
+				unique = true;
+				for (int j = 0; j < i; ++j)
+					unique &= (int)roots[i] != (int)roots[j];
+			} while (!unique);
+			// $1 - x\,pe^{-(l+1)}$ vanishes at location l
+			IndexType factor(rcp(roots[i] * IndexType(1)));
+			locator[i+1] = ValueType(0);
+			for (int j = i + 1; j > 0; --j)
+				locator[j] += factor * locator[j-1];
+		}
+	}
+	std::vector<IndexType> found(LOOPS * NR), expected(LOOPS * NR);
+	std::vector<int> counts(LOOPS), expected_counts(LOOPS);
+	auto start = std::chrono::steady_clock::now();
+	for (int loop = 0; loop < LOOPS; ++loop)
+		counts[loop] = Chien<NR, GF>::search(locators.data() + loop * (NR+1), degrees[loop], found.data() + loop * NR, SHORTENED);
+	auto middle = std::chrono::steady_clock::now();
+	for (int loop = 0; loop < LOOPS; ++loop)
+		expected_counts[loop] = Chien<NR, GF>::search(locators.data() + loop * (NR+1), degrees[loop], expected.data() + loop * NR, SHORTENED, GF::N, std::false_type());
+	auto end = std::chrono::steady_clock::now();
+	for (int loop = 0; loop < LOOPS; ++loop) {
+		error |= counts[loop] != degrees[loop] || expected_counts[loop] != degrees[loop];
+		for (int i = 0; i < counts[loop] && i < expected_counts[loop]; ++i)
+			error |= (int)found[loop*NR+i] != (int)expected[loop*NR+i];
+	}
+	std::cout << "Chien search of " << LOOPS << " locators took " << std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count() << " microseconds instead of " << std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count() << "." << std::endl;
+	// encoded blocks have to be codewords, also by the portable syndromes
+	std::vector<typename GF::value_type> code(N);
+	for (int loop = 0; loop < 1000; ++loop) {
+		for (int i = 0; i < K; ++i)
+			code[i] = symbol(generator);
+		rs.encode(code.data());
+		ValueType syndromes[NR];
+		Syndromes<NR, FCR, GF>::horner(reinterpret_cast<ValueType *>(code.data()), syndromes, N);
+		for (int i = 0; i < NR; ++i)
+			error |= !!syndromes[i];
+	}
+	if (error)
+		std::cout << "affine " << name << " error!" << std::endl;
+	assert(!error);
+}
+
+template <typename CODEC>
+void test_interleaved(std::string name, CODEC &codec, int depth, int symbol_max)
+{
+	typedef typename CODEC::value_type TYPE;
+	const int N = CODEC::N, K = CODEC::K, NR = N - K;
+	std::default_random_engine generator(depth);
+	std::uniform_int_distribution<int> symbol(0, symbol_max), noise(1, symbol_max), position(0, N-1);
+	// symbol i of codeword d is at frame[i*depth+d], the columns are the same codewords one after another
+	std::vector<TYPE> frame(N * depth), orig, columns(N * depth);
+	for (int i = 0; i < K * depth; ++i)
+		frame[i] = symbol(generator);
+	for (int d = 0; d < depth; ++d)
+		codec.encode(frame.data() + d, depth);
+	for (int d = 0; d < depth; ++d) {
+		for (int i = 0; i < K; ++i)
+			columns[d*N+i] = frame[i*depth+d];
+		codec.encode(columns.data() + d * N);
+	}
+	bool error = false;
+	for (int d = 0; d < depth; ++d)
+		for (int i = 0; i < N; ++i)
+			error |= columns[d*N+i] != frame[i*depth+d];
+	orig = frame;
+	// up to T errors in every other codeword, the rest stays clean
+	int corrupt = 0, dirty = 0;
+	for (int d = 0; d < depth; d += 2, ++dirty) {
+		for (int e = 0, count = 1 + d / 2 % (NR / 2); e < count; ++e) {
+			int i = position(generator);
+			if (frame[i*depth+d] == orig[i*depth+d]) {
+				frame[i*depth+d] ^= noise(generator);
+				++corrupt;
+			}
+		}
+	}
+	for (int d = 0; d < depth; ++d)
+		for (int i = 0; i < N; ++i)
+			columns[d*N+i] = frame[i*depth+d];
+	std::vector<TYPE> syndromes(NR * depth), expected(NR * depth);
+	auto start = std::chrono::steady_clock::now();
+	for (int d = 0; d < depth; ++d) {
+		TYPE column[N];
+		for (int i = 0; i < N; ++i)
+			column[i] = frame[i*depth+d];
+		codec.compute_syndromes(column, expected.data() + d * NR);
+	}
+	auto middle = std::chrono::steady_clock::now();
+	error |= codec.compute_syndromes_interleaved(frame.data(), syndromes.data(), depth) != dirty;
+	auto end = std::chrono::steady_clock::now();
+	error |= syndromes != expected;
+	for (int d = 0; d < depth; ++d) {
+		codec.compute_syndromes(frame.data() + d, syndromes.data() + d * NR, depth);
+		for (int i = 0; i < NR; ++i)
+			error |= syndromes[d*NR+i] != expected[d*NR+i];
+	}
+	std::cout << "interleaved syndromes of " << depth << " codewords took " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - middle).count() << " nanoseconds instead of " << std::chrono::duration_cast<std::chrono::nanoseconds>(middle - start).count() << "." << std::endl;
+	std::vector<int> results(depth);
+	error |= codec.decode_interleaved(frame.data(), depth, results.data()) != corrupt;
+	for (int d = 0; d < depth; ++d)
+		error |= results[d] < 0 || (d % 2 && results[d]);
+	error |= frame != orig;
+	// a single strided codeword, with half of its parity spent on erasures
+	TYPE erasures[NR];
+	for (int d = 0; d < depth; ++d) {
+		int corrupted = 0;
+		for (int i = 0; i < NR / 2; ++i) {
+			erasures[i] = N - 1 - 2 * i;
+			if (i % 2) {
+				frame[(N-1-2*i)*depth+d] ^= noise(generator);
+				++corrupted;
+			}
+		}
+		error |= codec.decode(frame.data() + d, depth, erasures, NR / 2) != corrupted;
+	}
+	error |= frame != orig;
+	if (error)
+		std::cout << "interleaved " << name << " error!" << std::endl;
+	assert(!error);
+}
+
+template <typename CODEC>
+void test_incremental(std::string name, CODEC &codec, int K, int T, int symbol_max)
+{
+	typedef typename CODEC::value_type TYPE;
+	const int N = CODEC::N, NR = 2 * T;
+	std::default_random_engine generator(N);
+	std::uniform_int_distribution<int> symbol(0, symbol_max), noise(1, symbol_max), position(0, N-1);
+	std::vector<TYPE> orig(N), code(N), syndromes(NR), expected(NR);
+	bool error = false;
+	long long took = 0, full = 0;
+	int updates = 0;
+	for (int s = 0; s < 10; ++s) {
+		for (int i = 0; i < K; ++i)
+			orig[i] = symbol(generator);
+		codec.encode(orig.data());
+		code = orig;
+		error |= codec.compute_syndromes(code.data(), syndromes.data()) != 0;
+		// twice as many errors as the code can take, then half of them get repaired again
+		int errors = 2 * T;
+		std::vector<int> positions(errors);
+		for (int i = 0; i < errors; ++i) {
+			for (bool again = true; again;) {
+				positions[i] = position(generator);
+				again = false;
+				for (int j = 0; j < i; ++j)
+					again |= positions[j] == positions[i];
+			}
+			codec.replace_symbol(code.data(), syndromes.data(), positions[i], code[positions[i]] ^ noise(generator));
+		}
+		auto start = std::chrono::steady_clock::now();
+		codec.compute_syndromes(code.data(), expected.data());
+		auto middle = std::chrono::steady_clock::now();
+		error |= syndromes != expected;
+		for (int i = 0; i < T; ++i)
+			codec.replace_symbol(code.data(), syndromes.data(), positions[i], orig[positions[i]]);
+		auto end = std::chrono::steady_clock::now();
+		full += std::chrono::duration_cast<std::chrono::nanoseconds>(middle - start).count();
+		took += std::chrono::duration_cast<std::chrono::nanoseconds>(end - middle).count();
+		updates += T;
+		codec.compute_syndromes(code.data(), expected.data());
+		error |= syndromes != expected;
+		error |= codec.decode_syndromes(code.data(), syndromes.data()) != T;
+		error |= code != orig;
+		for (int i = 0; i < NR; ++i)
+			error |= !!syndromes[i];
+	}
+	if (error)
+		std::cout << "incremental syndromes " << name << " error!" << std::endl;
+	assert(!error);
+	std::cout << "updating the syndromes took " << took / updates << " nanoseconds per symbol instead of " << full / 10 << " nanoseconds for all of them." << std::endl;
 }
 
 int main()
 {
-	std::random_device rd;
-	std::default_random_engine generator(rd());
+	std::default_random_engine generator(65471);
 	std::uniform_int_distribution<uint8_t> distribution(0, 255);
 	std::vector<uint8_t> data(65471*16);
 	std::generate(data.begin(), data.end(), std::bind(distribution, generator));
@@ -331,12 +1284,26 @@ int main()
 		uint8_t code[15] = { 1, 1, 0, 0, 1 };
 		uint8_t target[15] = { 1, 1, 0, 0, 1, 0, 0, 0, 1, 1, 1, 1, 0, 1, 0 };
 		test_bch("NASA INTRO BCH(15, 5) T=3", bch, code, target, data);
+		test_field<GF::Types<4, 0b10011, uint8_t>>("NASA INTRO BCH(15, 5) T=3");
+		test_latency("NASA INTRO BCH(15, 5) T=3", bch, 5, 3, 1);
+		test_constant_time("NASA INTRO BCH(15, 5) T=3", bch, 5, 3, 1);
+		test_batch("NASA INTRO BCH(15, 5) T=3", bch, 5, 3, 1);
+		test_incremental("NASA INTRO BCH(15, 5) T=3", bch, 5, 3, 1);
 	}
 	if (1) {
 		ReedSolomon<4, 0, GF::Types<4, 0b10011, uint8_t>> rs;
 		uint8_t code[15] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
 		uint8_t target[15] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 3, 3, 12, 12 };
 		test_rs("BBC WHP031 RS(15, 11) T=2", rs, code, target, data);
+		test_field<GF::Types<4, 0b10011, uint8_t>>("BBC WHP031 RS(15, 11) T=2");
+		test_latency("BBC WHP031 RS(15, 11) T=2", rs, 11, 2, 15);
+		test_constant_time("BBC WHP031 RS(15, 11) T=2", rs, 11, 2, 15);
+		test_batch("BBC WHP031 RS(15, 11) T=2", rs, 11, 2, 15);
+		test_erasures("BBC WHP031 RS(15, 11) T=2", rs, 11, 15);
+		test_incremental("BBC WHP031 RS(15, 11) T=2", rs, 11, 2, 15);
+		BitSlicedReedSolomon<4, 0, GF::Types<4, 0b10011, uint8_t>> sliced;
+		test_bit_sliced("BBC WHP031 RS(15, 11) T=2", rs, sliced, 15);
+		test_interleaved("BBC WHP031 RS(15, 11) T=2", rs, 5, 15);
 	}
 	if (1) {
 		ReedSolomon<16, 0, GF::Types<8, 0b100011101, uint8_t>> rs;
@@ -347,6 +1314,44 @@ int main()
 		for (int i = 0; i < 16; ++i)
 			target[239+i] = parity[i];
 		test_rs("DVB-T RS(255, 239) T=8", rs, code, target, data);
+		test_field<GF::Types<8, 0b100011101, uint8_t>>("DVB-T RS(255, 239) T=8");
+		test_latency("DVB-T RS(255, 239) T=8", rs, 239, 8, 255);
+		test_constant_time("DVB-T RS(255, 239) T=8", rs, 239, 8, 255);
+		test_batch("DVB-T RS(255, 239) T=8", rs, 239, 8, 255);
+		test_erasures("DVB-T RS(255, 239) T=8", rs, 239, 255);
+		test_incremental("DVB-T RS(255, 239) T=8", rs, 239, 8, 255);
+		BitSlicedReedSolomon<16, 0, GF::Types<8, 0b100011101, uint8_t>> sliced;
+		test_bit_sliced("DVB-T RS(255, 239) T=8", rs, sliced, 255);
+		test_interleaved("DVB-T RS(255, 239) T=8", rs, 100, 255);
+		test_affine("DVB-T RS(255, 239) T=8", rs);
+	}
+	if (1) {
+		ReedSolomon<16, 0, GF::Types<8, 0b100011101, uint8_t>, 204> rs;
+		uint8_t code[204], target[204];
+		for (int i = 0; i < 188; ++i)
+			target[i] = code[i] = i + 1;
+		uint8_t parity[16] = { 195, 231, 90, 194, 142, 112, 85, 171, 63, 242, 251, 154, 1, 82, 33, 222 };
+		for (int i = 0; i < 16; ++i)
+			target[188+i] = parity[i];
+		test_rs("DVB-T RS(204, 188) T=8", rs, code, target, data);
+		test_field<GF::Types<8, 0b100011101, uint8_t>>("DVB-T RS(204, 188) T=8");
+		test_latency("DVB-T RS(204, 188) T=8", rs, 188, 8, 255);
+		test_constant_time("DVB-T RS(204, 188) T=8", rs, 188, 8, 255);
+		test_batch("DVB-T RS(204, 188) T=8", rs, 188, 8, 255);
+		test_erasures("DVB-T RS(204, 188) T=8", rs, 188, 255);
+		test_incremental("DVB-T RS(204, 188) T=8", rs, 188, 8, 255);
+		BitSlicedReedSolomon<16, 0, GF::Types<8, 0b100011101, uint8_t>, 204> sliced;
+		test_bit_sliced("DVB-T RS(204, 188) T=8", rs, sliced, 255);
+		test_interleaved("DVB-T RS(204, 188) T=8", rs, 12, 255);
+		test_affine("DVB-T RS(204, 188) T=8", rs);
+	}
+	if (1) {
+		ReedSolomon<16, 0, GF::Types<8, 0b100011101, uint8_t>> rs;
+		test_stream<1>("DVB-T RS(255, 239) T=8 STREAM", rs, data);
+	}
+	if (1) {
+		ReedSolomon<16, 0, GF::Types<8, 0b100011101, uint8_t>, 204> rs;
+		test_stream<12>("DVB-T RS(204, 188) T=8 STREAM DEPTH=12", rs, data);
 	}
 	if (1) {
 		BoseChaudhuriHocquenghem<24, 1, 65343, GF::Types<16, 0b10000000000101101, uint16_t>> bch({0b10000000000101101, 0b10000000101110011, 0b10000111110111101, 0b10101101001010101, 0b10001111100101111, 0b11111011110110101, 0b11010111101100101, 0b10111001101100111, 0b10000111010100001, 0b10111010110100111, 0b10011101000101101, 0b10001101011100011});
@@ -357,6 +1362,33 @@ int main()
 		for (int i = 0; i < 192; ++i)
 			target[65343+i] = parity[i];
 		test_bch("DVB-S2 FULL BCH(65535, 65343) T=12", bch, code, target, data);
+		test_field<GF::Types<16, 0b10000000000101101, uint16_t>>("DVB-S2 FULL BCH(65535, 65343) T=12");
+		test_latency("DVB-S2 FULL BCH(65535, 65343) T=12", bch, 65343, 12, 1);
+		test_constant_time("DVB-S2 FULL BCH(65535, 65343) T=12", bch, 65343, 12, 1);
+		test_batch("DVB-S2 FULL BCH(65535, 65343) T=12", bch, 65343, 12, 1);
+		test_parallel("DVB-S2 FULL BCH(65535, 65343) T=12", bch, 65343, 12, 1);
+		test_incremental("DVB-S2 FULL BCH(65535, 65343) T=12", bch, 65343, 12, 1);
+	}
+	if (1) {
+		test_arithmetic<16, 0b10000000000101101, uint16_t>("DVB-S2 GF(2^16)");
+		BoseChaudhuriHocquenghem<24, 1, 65343, GF::Types<16, 0b10000000000101101, uint16_t, GF::CarrylessArithmetic>> bch({0b10000000000101101, 0b10000000101110011, 0b10000111110111101, 0b10101101001010101, 0b10001111100101111, 0b11111011110110101, 0b11010111101100101, 0b10111001101100111, 0b10000111010100001, 0b10111010110100111, 0b10011101000101101, 0b10001101011100011});
+		test_latency("DVB-S2 FULL BCH(65535, 65343) T=12 CARRYLESS", bch, 65343, 12, 1);
+	}
+	if (1) {
+		BoseChaudhuriHocquenghem<24, 1, 58128, GF::Types<16, 0b10000000000101101, uint16_t>, 58320> bch({0b10000000000101101, 0b10000000101110011, 0b10000111110111101, 0b10101101001010101, 0b10001111100101111, 0b11111011110110101, 0b11010111101100101, 0b10111001101100111, 0b10000111010100001, 0b10111010110100111, 0b10011101000101101, 0b10001101011100011});
+		uint16_t code[58320], target[58320];
+		for (int i = 0, s = 0; i < 58128; ++i, s=(s*(s*s*51767+71287)+35149)&0xffffff)
+			target[i] = code[i] = (s^=s>>7)&1;
+		uint16_t parity[192] = { 0, 0, 0, 1, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0, 1, 1, 0, 1, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0, 1, 0, 1, 0, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 0, 1, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 0, 1, 1, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1, 0, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 1, 0, 1, 1, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 1, 1, 0, 0, 0, 0, 1, 0, 1, 0, 1, 1, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 1, 1, 0, 0, 0, 1, 1, 1, 0, 1, 1, 1, 0, 0, 1, 1, 0, 1, 1, 0, 1 };
+		for (int i = 0; i < 192; ++i)
+			target[58128+i] = parity[i];
+		test_bch("DVB-S2 NORMAL BCH(58320, 58128) T=12", bch, code, target, data);
+		test_field<GF::Types<16, 0b10000000000101101, uint16_t>>("DVB-S2 NORMAL BCH(58320, 58128) T=12");
+		test_latency("DVB-S2 NORMAL BCH(58320, 58128) T=12", bch, 58128, 12, 1);
+		test_constant_time("DVB-S2 NORMAL BCH(58320, 58128) T=12", bch, 58128, 12, 1);
+		test_batch("DVB-S2 NORMAL BCH(58320, 58128) T=12", bch, 58128, 12, 1);
+		test_parallel("DVB-S2 NORMAL BCH(58320, 58128) T=12", bch, 58128, 12, 1);
+		test_incremental("DVB-S2 NORMAL BCH(58320, 58128) T=12", bch, 58128, 12, 1);
 	}
 	if (1) {
 		ReedSolomon<64, 1, GF::Types<16, 0b10001000000001011, uint16_t>> rs;
@@ -367,6 +1399,31 @@ int main()
 		for (int i = 0; i < 64; ++i)
 			target[65471+i] = parity[i];
 		test_rs("FUN RS(65535, 65471) T=32", rs, code, target, data);
+		test_field<GF::Types<16, 0b10001000000001011, uint16_t>>("FUN RS(65535, 65471) T=32");
+		test_latency("FUN RS(65535, 65471) T=32", rs, 65471, 32, 65535);
+		test_constant_time("FUN RS(65535, 65471) T=32", rs, 65471, 32, 65535);
+		test_batch("FUN RS(65535, 65471) T=32", rs, 65471, 32, 65535);
+		test_erasures("FUN RS(65535, 65471) T=32", rs, 65471, 65535);
+		test_incremental("FUN RS(65535, 65471) T=32", rs, 65471, 32, 65535);
+		test_parallel("FUN RS(65535, 65471) T=32", rs, 65471, 32, 65535);
+	}
+	if (1) {
+		test_arithmetic<16, 0b10001000000001011, uint16_t>("FUN GF(2^16)");
+		ReedSolomon<64, 1, GF::Types<16, 0b10001000000001011, uint16_t, GF::CarrylessArithmetic>> rs;
+		test_latency("FUN RS(65535, 65471) T=32 CARRYLESS", rs, 65471, 32, 65535);
+	}
+	if (1) {
+		test_lin_chung_han<GF::Types<8, 0b100011101, uint8_t>>("LCH GF(2^8)", 150, 50, 1024);
+		test_lin_chung_han<GF::Types<16, 0b10001000000001011, uint16_t>>("LCH GF(2^16)", 10, 4, 7);
+		test_lin_chung_han<GF::Types<16, 0b10001000000001011, uint16_t>>("LCH GF(2^16)", 256, 64, 4096);
+		test_lin_chung_han<GF::Types<16, 0b10001000000001011, uint16_t>>("LCH GF(2^16)", 3000, 1000, 16);
+	}
+	if (1) {
+		test_solvers<6, 1, GF::Types<4, 0b10011, uint8_t>>("NASA INTRO BCH(15, 5) T=3", true);
+		test_solvers<4, 0, GF::Types<4, 0b10011, uint8_t>>("BBC WHP031 RS(15, 11) T=2", false);
+		test_solvers<16, 0, GF::Types<8, 0b100011101, uint8_t>>("DVB-T RS(255, 239) T=8", false);
+		test_solvers<24, 1, GF::Types<16, 0b10000000000101101, uint16_t>>("DVB-S2 FULL BCH(65535, 65343) T=12", true);
+		test_solvers<64, 1, GF::Types<16, 0b10001000000001011, uint16_t>>("FUN RS(65535, 65471) T=32", false);
 	}
 }
 
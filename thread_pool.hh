@@ -0,0 +1,127 @@
+/*
+FEC - Forward error correction
+Written in 2017 by <Ahmet Inan> <xdsopl@gmail.com>
+To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide. This software is distributed without any warranty.
+You should have received a copy of the CC0 Public Domain Dedication along with this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#ifndef THREAD_POOL_HH
+#define THREAD_POOL_HH
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class ThreadPool
+{
+	// each worker owns a range of items and steals from the others when done
+	struct Range
+	{
+		std::atomic<int> next;
+		int end;
+		char padding[64 - sizeof(std::atomic<int>) - sizeof(int)];
+	};
+	int size;
+	std::unique_ptr<Range[]> ranges;
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable wake, done;
+	std::function<void(int)> task;
+	int generation = 0, busy = 0;
+	bool quit = false;
+	// the pool whose task the calling thread is working on, if any
+	static const ThreadPool *&current()
+	{
+		thread_local const ThreadPool *pool = nullptr;
+		return pool;
+	}
+	void work(int id)
+	{
+		for (int k = 0; k < size; ++k) {
+			Range &range = ranges[(id + k) % size];
+			for (int i; (i = range.next.fetch_add(1, std::memory_order_relaxed)) < range.end;)
+				task(i);
+		}
+	}
+	void loop(int id)
+	{
+		current() = this;
+		for (int seen = 0;;) {
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [&]{ return quit || generation != seen; });
+				if (quit)
+					return;
+				seen = generation;
+			}
+			work(id);
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!--busy)
+				done.notify_one();
+		}
+	}
+public:
+	// zero threads means one per hardware thread, the caller is one of them
+	explicit ThreadPool(int count = 0) :
+		size(count > 0 ? count : std::max(1, (int)std::thread::hardware_concurrency())),
+		ranges(new Range[size])
+	{
+		for (int i = 1; i < size; ++i)
+			threads.emplace_back(&ThreadPool::loop, this, i);
+	}
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quit = true;
+		}
+		wake.notify_all();
+		for (auto &thread: threads)
+			thread.join();
+	}
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+	int threads_count() const
+	{
+		return size;
+	}
+	/*
+	calls func(i) for every $0 \le i < count$ and returns when all calls are done.
+	Only one thread at a time may call run on the same pool.
+	When func itself calls run on the same pool, e.g. through decode_parallel,
+	the nested calls are done inline, as all workers are busy with the outer run.
+	A single call is done inline too, waking the workers would only add latency.
+	*/
+	void run(int count, std::function<void(int)> func)
+	{
+		if (count <= 1 || current() == this) {
+			for (int i = 0; i < count; ++i)
+				func(i);
+			return;
+		}
+		for (int i = 0; i < size; ++i) {
+			ranges[i].next = (long long)count * i / size;
+			ranges[i].end = (long long)count * (i + 1) / size;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			task = std::move(func);
+			busy = size - 1;
+			++generation;
+		}
+		wake.notify_all();
+		const ThreadPool *outer = current();
+		current() = this;
+		work(0);
+		current() = outer;
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [&]{ return !busy; });
+	}
+};
+
+#endif